@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "fastapprox.h"
+
+namespace imagiro {
+
+// A bank of N cubic-segment LFOs, with the same behaviour (and parameters) as
+// signalsmith::envelopes::CubicLfo, for running one LFO per voice per parameter.
+//
+// All the state is stored per-field (SoA), so next() steps every LFO in one vectorised loop.
+// New segments (random rate/target) are only needed every half-cycle, so those are done per-LFO
+// afterwards, using fastexp(). The random numbers come from a counter-based hash (each LFO has its
+// own key, and counts how many numbers it's used), so an LFO gives the same output whether it's
+// run with next() or with process(index, ...).
+template <int N>
+class LfoBank {
+public:
+    explicit LfoBank(uint32_t seed = std::random_device()()) {
+        for (int i = 0; i < N; ++i) {
+            key[i] = hash(seed + uint32_t(i) * 0x9E3779B9u);
+        }
+        reset();
+    }
+
+    static constexpr int size() { return N; }
+
+    void setPhase(int index, float phase01) {
+        ratio[index] = phase01;
+    }
+
+    // Resets every LFO, each starting with a random phase
+    void reset() {
+        for (int i = 0; i < N; ++i) reset(i);
+    }
+
+    void reset(int index) {
+        ratio[index] = random(index);
+        ratioStep[index] = randomRate(index);
+        bool upwards = random(index) < 0.5f;
+        valueFrom[index] = upwards ? targetLow[index] : targetHigh[index];
+        valueTo[index] = upwards ? targetHigh[index] : targetLow[index];
+        valueRange[index] = valueTo[index] - valueFrom[index];
+        freshReset[index] = true;
+    }
+
+    // Same as CubicLfo::set(): a full oscillation takes (approximately) 1/rate samples
+    void set(int index, float low, float high, float rate, float rateVariation = 0, float depthVariation = 0) {
+        rate *= 2; // up and down during this period
+        targetRate[index] = rate;
+        targetLow[index] = std::min(low, high);
+        targetHigh[index] = std::max(low, high);
+        rateRandom[index] = rateVariation;
+        depthRandom[index] = std::clamp(depthVariation, 0.0f, 1.0f);
+
+        if (freshReset[index]) return reset(index);
+
+        // Only update the current rate if it's outside the new random-variation range
+        float maxRandomRatio = fastexp(0.5f * rateRandom[index]);
+        if (ratioStep[index] > rate * maxRandomRatio || ratioStep[index] < rate / maxRandomRatio) {
+            ratioStep[index] = randomRate(index);
+        }
+    }
+
+    // Writes the next sample of every LFO to output[0..N)
+    void next(float* output) {
+        int wrapped = 0;
+        for (int i = 0; i < N; ++i) {
+            float r = ratio[i], nextRatio = r + ratioStep[i];
+            output[i] = r * r * (3 - 2 * r) * valueRange[i] + valueFrom[i];
+            ratio[i] = nextRatio;
+            wrapped += nextRatio >= 1;
+        }
+        std::fill(freshReset, freshReset + N, false);
+
+        if (wrapped > 0) {
+            for (int i = 0; i < N; ++i) {
+                while (ratio[i] >= 1) startSegment(i);
+            }
+        }
+    }
+
+    // Runs every LFO for a block, writing to outputs[lfo][0..length)
+    void process(float* const* outputs, int length) {
+        float frame[N];
+        for (int s = 0; s < length; ++s) {
+            next(frame);
+            for (int i = 0; i < N; ++i) outputs[i][s] = frame[i];
+        }
+    }
+
+    // Runs a single LFO for a block (independently of the others)
+    void process(int index, float* output, int length) {
+        freshReset[index] = false;
+        float r = ratio[index], step = ratioStep[index];
+        for (int s = 0; s < length; ++s) {
+            output[s] = r * r * (3 - 2 * r) * valueRange[index] + valueFrom[index];
+            r += step;
+            if (r >= 1) {
+                ratio[index] = r;
+                while (ratio[index] >= 1) startSegment(index);
+                r = ratio[index];
+                step = ratioStep[index];
+            }
+        }
+        ratio[index] = r;
+    }
+
+private:
+    alignas(32) float ratio[N] = {}, ratioStep[N] = {};
+    alignas(32) float valueFrom[N] = {}, valueTo[N] = {}, valueRange[N] = {};
+    alignas(32) float targetLow[N] = {}, targetHigh[N] = {}, targetRate[N] = {};
+    alignas(32) float rateRandom[N] = {}, depthRandom[N] = {};
+    alignas(32) uint32_t key[N] = {}, counter[N] = {};
+    bool freshReset[N] = {};
+
+    // "lowbias32" integer hash
+    static uint32_t hash(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+    // Uniform in [0, 1), from the top 24 bits
+    static float unitFromHash(uint32_t x) {
+        return float(x >> 8) * (1.0f / 16777216.0f);
+    }
+    float randomAt(int index, uint32_t position) const {
+        return unitFromHash(hash(key[index] + position * 0x9E3779B9u));
+    }
+    float random(int index) {
+        return randomAt(index, counter[index]++);
+    }
+
+    float rateFromRandom(int index, float unit) const {
+        return targetRate[index] * fastexp(rateRandom[index] * (unit - 0.5f));
+    }
+    float randomRate(int index) {
+        return rateFromRandom(index, random(index));
+    }
+    float targetFromRandom(int index, float previous, float unit) const {
+        float low = targetLow[index], high = targetHigh[index];
+        float randomOffset = depthRandom[index] * unit * (low - high);
+        return previous < (low + high) * 0.5f ? high + randomOffset : low - randomOffset;
+    }
+
+    void startSegment(int index) {
+        ratio[index] -= 1;
+        ratioStep[index] = randomRate(index);
+        valueFrom[index] = valueTo[index];
+        valueTo[index] = targetFromRandom(index, valueFrom[index], random(index));
+        valueRange[index] = valueTo[index] - valueFrom[index];
+    }
+};
+
+} // namespace imagiro
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "dsp/convolution.h"
+#include "readerwriterqueue/readerwriterqueue.h"
+
+namespace imagiro {
+
+// Non-uniformly partitioned (Gardner-style) convolver, for long IRs such as reverbs.
+//
+// The head of the IR is convolved on the audio thread with small partitions. Each later section
+// uses 4x bigger partitions, and is computed on its own worker thread, fed through a lock-free queue.
+// A tail stage with block size B covers the IR from 2B onwards: each input block is handed over as
+// soon as it's complete, and its result isn't needed until one whole block later. If a worker misses
+// that deadline the audio thread waits for it rather than dropping the block, so the output is
+// sample-exact (and identical to running without worker threads).
+class NonUniformConvolver {
+public:
+    explicit NonUniformConvolver(bool useWorkerThreads = true) : useWorkerThreads(useWorkerThreads) {}
+
+    ~NonUniformConvolver() {
+        stopWorkers();
+    }
+
+    // Allocates everything and starts the workers. The IRs are cleared.
+    // maxHostBlockSize is the largest block passed to process(): the first tail stage is at least
+    // this big, so its worker always has (at least) one host block to finish.
+    void prepare(int nInputs, int nOutputs, int maxIrLength, int headBlockSize, int maxHostBlock) {
+        stopWorkers();
+        tailStages.clear();
+
+        numInputs = nInputs;
+        numOutputs = nOutputs;
+        maxHostBlockSize = std::max(maxHostBlock, 1);
+        inputCopy.assign(numInputs * maxHostBlockSize, 0);
+
+        int blockSize = std::max(headBlockSize * 4, nextPowerOfTwo(maxHostBlockSize));
+        headLength = std::min(2 * blockSize, maxIrLength);
+        head.resize(numInputs, numOutputs, headBlockSize, headLength);
+
+        int covered = headLength;
+        while (covered < maxIrLength) {
+            int nextBlockSize = blockSize * 4;
+            bool last = 2 * nextBlockSize >= maxIrLength || blockSize >= maxTailBlockSize;
+            int end = last ? maxIrLength : 2 * nextBlockSize;
+
+            auto stage = std::make_unique<Stage>();
+            stage->blockSize = blockSize;
+            stage->irStart = covered;
+            stage->irEnd = end;
+            stage->convolver.resize(numInputs, numOutputs, blockSize, end - covered);
+            for (auto& slot : stage->slots) {
+                slot.input.assign(numInputs * blockSize, 0);
+                slot.output.assign(numOutputs * blockSize, 0);
+            }
+            tailStages.push_back(std::move(stage));
+
+            covered = end;
+            blockSize = nextBlockSize;
+        }
+
+        if (useWorkerThreads) {
+            for (auto& stage : tailStages) {
+                Stage* s = stage.get();
+                s->worker = std::thread([this, s] { runWorker(*s); });
+            }
+        }
+    }
+
+    // Sets the IR from one input to one output. Waits for any outstanding tail blocks,
+    // so don't call this concurrently with process().
+    void setIr(int outChannel, int inChannel, const float* ir, int length) {
+        waitForWorkers();
+        head.setIr(outChannel, inChannel, ir, std::min(length, headLength));
+        for (auto& stage : tailStages) {
+            int sectionLength = std::clamp(length - stage->irStart, 0, stage->irEnd - stage->irStart);
+            stage->convolver.setIr(outChannel, inChannel, ir + (sectionLength > 0 ? stage->irStart : 0), sectionLength);
+        }
+    }
+
+    // Clears the input history (but not the IRs)
+    void reset() {
+        waitForWorkers();
+        head.reset();
+        for (auto& stage : tailStages) {
+            stage->convolver.reset();
+            stage->position = 0;
+            stage->blockIndex = 0;
+            for (auto& slot : stage->slots) {
+                slot.ready.store(false, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    int getLatency() const { return 0; }
+    int getNumTailStages() const { return (int) tailStages.size(); }
+
+    // Replaces the output. Input and output can be the same buffers.
+    void process(const float* const* input, float* const* output, int numSamples) {
+        int done = 0;
+        while (done < numSamples) {
+            int count = std::min(numSamples - done, maxHostBlockSize);
+            for (int c = 0; c < numInputs; ++c) {
+                std::copy(input[c] + done, input[c] + done + count, inputCopy.data() + c * maxHostBlockSize);
+            }
+
+            OffsetChannels out{output, done};
+            head.process(Channels{inputCopy.data(), maxHostBlockSize}, out, count);
+            for (auto& stage : tailStages) {
+                processStage(*stage, out, count);
+            }
+            done += count;
+        }
+    }
+
+private:
+    static constexpr int maxTailBlockSize = 65536;
+
+    struct Channels {
+        float* data;
+        int stride;
+        float* operator[](int channel) const { return data + channel * stride; }
+    };
+    struct OffsetChannels {
+        float* const* channels;
+        int offset;
+        float* operator[](int channel) const { return channels[channel] + offset; }
+    };
+
+    // Block k is collected into slots[k % 3], computed while block k + 1 is collected,
+    // and read out while block k + 2 is collected.
+    struct Slot {
+        std::vector<float> input, output;
+        std::atomic<bool> ready {false};
+    };
+    struct Stage {
+        int blockSize = 0, irStart = 0, irEnd = 0;
+        signalsmith::convolution::UniformConvolver<float> convolver;
+        Slot slots[3];
+        int position = 0;
+        size_t blockIndex = 0;
+
+        moodycamel::BlockingReaderWriterQueue<int> jobs {8};
+        std::thread worker;
+    };
+
+    bool useWorkerThreads;
+    int numInputs = 0, numOutputs = 0;
+    int maxHostBlockSize = 1;
+    int headLength = 0;
+    std::vector<float> inputCopy;
+    signalsmith::convolution::UniformConvolver<float> head;
+    std::vector<std::unique_ptr<Stage>> tailStages;
+
+    static int nextPowerOfTwo(int n) {
+        int result = 1;
+        while (result < n) result *= 2;
+        return result;
+    }
+
+    static void compute(Stage& stage, Slot& slot) {
+        stage.convolver.process(Channels{slot.input.data(), stage.blockSize},
+                                Channels{slot.output.data(), stage.blockSize}, stage.blockSize);
+        slot.ready.store(true, std::memory_order_release);
+    }
+
+    static void waitFor(const Slot& slot) {
+        while (!slot.ready.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void runWorker(Stage& stage) {
+        int slotIndex;
+        while (true) {
+            stage.jobs.wait_dequeue(slotIndex);
+            if (slotIndex < 0) return;
+            compute(stage, stage.slots[slotIndex]);
+        }
+    }
+
+    void processStage(Stage& stage, const OffsetChannels& out, int count) {
+        const int blockSize = stage.blockSize;
+        int done = 0;
+        while (done < count) {
+            int n = std::min(count - done, blockSize - stage.position);
+
+            Slot& collecting = stage.slots[stage.blockIndex % 3];
+            for (int c = 0; c < numInputs; ++c) {
+                const float* from = inputCopy.data() + c * maxHostBlockSize + done;
+                std::copy(from, from + n, collecting.input.data() + c * blockSize + stage.position);
+            }
+
+            if (stage.blockIndex >= 2) {
+                const Slot& result = stage.slots[(stage.blockIndex - 2) % 3];
+                waitFor(result);
+                for (int c = 0; c < numOutputs; ++c) {
+                    const float* from = result.output.data() + c * blockSize + stage.position;
+                    float* to = out[c] + done;
+                    for (int i = 0; i < n; ++i) to[i] += from[i];
+                }
+            }
+
+            done += n;
+            stage.position += n;
+            if (stage.position == blockSize) {
+                stage.position = 0;
+                int slotIndex = (int) (stage.blockIndex % 3);
+                collecting.ready.store(false, std::memory_order_relaxed);
+                if (!useWorkerThreads || !stage.jobs.try_enqueue(slotIndex)) {
+                    compute(stage, collecting);
+                }
+                ++stage.blockIndex;
+            }
+        }
+    }
+
+    // Waits for the (up to two) blocks which might still be in flight
+    void waitForWorkers() {
+        for (auto& stage : tailStages) {
+            for (size_t back = 1; back <= 2 && back <= stage->blockIndex; ++back) {
+                waitFor(stage->slots[(stage->blockIndex - back) % 3]);
+            }
+        }
+    }
+
+    void stopWorkers() {
+        for (auto& stage : tailStages) {
+            if (stage->worker.joinable()) {
+                stage->jobs.enqueue(-1);
+                stage->worker.join();
+            }
+        }
+    }
+};
+
+} // namespace imagiro
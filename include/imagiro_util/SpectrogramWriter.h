@@ -0,0 +1,176 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "WorkerPool.h"
+#include "dsp/spectral.h"
+
+namespace imagiro {
+
+// Offline spectrogram pipeline: streams an audio file through a windowed FFT, writing magnitude
+// frames into a memory-mapped output file.
+//
+// The audio is read (and the output mapped) one chunk of frames at a time, so memory use depends on
+// the chunk size, not the file length. Frames only depend on the input, so each chunk's frames are
+// split across a WorkerPool.
+//
+// Output layout: a Header (padded to headerSize bytes), then numFrames x numChannels x numBins
+// native-endian floats. Frame k starts at input sample k * hopSize, and the input is zero-padded
+// past its end.
+class SpectrogramWriter {
+public:
+    struct Options {
+        int fftSize = 2048;
+        int hopSize = 512;
+        int framesPerChunk = 256;
+        int numThreads = (int) std::max(std::thread::hardware_concurrency(), 1u);
+    };
+
+    struct Header {
+        char magic[4] = {'I', 'S', 'P', 'G'};
+        int32_t version = 1;
+        int32_t numChannels = 0;
+        int32_t numBins = 0;
+        int32_t fftSize = 0;
+        int32_t hopSize = 0;
+        int64_t numFrames = 0;
+        double sampleRate = 0;
+    };
+    static constexpr int headerSize = 64;
+    static_assert(sizeof(Header) <= headerSize);
+
+    SpectrogramWriter() : SpectrogramWriter(Options{}) {}
+
+    explicit SpectrogramWriter(Options o)
+            : options(o), pool(std::max(o.numThreads - 1, 0), 1000) {
+        jassert(options.fftSize > 0 && options.fftSize % 2 == 0);
+        jassert(options.hopSize > 0 && options.framesPerChunk > 0);
+
+        jobs.resize(pool.getNumWorkers() + 1);
+        for (auto& job : jobs) {
+            job.fft.setSize(options.fftSize);
+            job.spectrum.resize(options.fftSize / 2);
+        }
+    }
+
+    bool process(const juce::File& audioFile, const juce::File& outputFile) {
+        juce::AudioFormatManager afm;
+        afm.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader (afm.createReaderFor(audioFile));
+        if (!reader) return false;
+
+        return process(*reader, outputFile);
+    }
+
+    // Returns false if the input couldn't be read, or the output couldn't be written
+    bool process(juce::AudioFormatReader& reader, const juce::File& outputFile) {
+        const int numChannels = (int) reader.numChannels;
+        const int hop = options.hopSize;
+
+        Header header;
+        header.numChannels = numChannels;
+        header.numBins = options.fftSize / 2;
+        header.fftSize = options.fftSize;
+        header.hopSize = hop;
+        header.numFrames = (reader.lengthInSamples + hop - 1) / hop;
+        header.sampleRate = reader.sampleRate;
+
+        const juce::int64 frameBytes = (juce::int64) numChannels * header.numBins * (juce::int64) sizeof(float);
+        if (!createOutputFile(outputFile, header, headerSize + header.numFrames * frameBytes)) return false;
+
+        const int chunkSamples = (options.framesPerChunk - 1) * hop + options.fftSize;
+        input.setSize(numChannels, chunkSamples, false, false, true);
+
+        for (juce::int64 first = 0; first < header.numFrames; first += options.framesPerChunk) {
+            const int count = (int) std::min<juce::int64>(options.framesPerChunk, header.numFrames - first);
+
+            // the reader zero-fills anything past the end of the file
+            if (!reader.read(input.getArrayOfWritePointers(), numChannels, first * hop, chunkSamples)) return false;
+
+            const juce::int64 start = headerSize + first * frameBytes;
+            juce::MemoryMappedFile mapped (outputFile, {start, start + count * frameBytes},
+                                           juce::MemoryMappedFile::readWrite);
+            if (mapped.getData() == nullptr) return false;
+
+            // the mapped range gets rounded down to a page boundary
+            auto* data = static_cast<char*>(mapped.getData()) + (start - mapped.getRange().getStart());
+            Chunk chunk {*this, reinterpret_cast<float*>(data), count, numChannels, header.numBins};
+            pool.run((int) jobs.size(), Chunk::run, &chunk);
+        }
+
+        return true;
+    }
+
+    static std::optional<Header> readHeader(const juce::File& file) {
+        juce::FileInputStream in (file);
+        Header header;
+        if (!in.openedOk() || in.read(&header, sizeof(Header)) != (int) sizeof(Header)) return {};
+        if (std::memcmp(header.magic, Header{}.magic, 4) != 0 || header.version != Header{}.version) return {};
+        return header;
+    }
+
+private:
+    Options options;
+    WorkerPool pool;
+
+    struct Job {
+        signalsmith::spectral::WindowedFFT<float> fft;
+        std::vector<std::complex<float>> spectrum;
+    };
+    std::vector<Job> jobs;
+    juce::AudioBuffer<float> input;
+
+    // Each job computes a contiguous run of the chunk's frames
+    struct Chunk {
+        SpectrogramWriter& writer;
+        float* output;
+        int numFrames, numChannels, numBins;
+
+        static void run(void* context, int jobIndex) {
+            auto& chunk = *static_cast<Chunk*>(context);
+            auto& writer = chunk.writer;
+            auto& job = writer.jobs[jobIndex];
+            const int numJobs = (int) writer.jobs.size();
+
+            const int begin = chunk.numFrames * jobIndex / numJobs;
+            const int end = chunk.numFrames * (jobIndex + 1) / numJobs;
+            for (int f = begin; f < end; ++f) {
+                for (int c = 0; c < chunk.numChannels; ++c) {
+                    job.fft.fft(writer.input.getReadPointer(c, f * writer.options.hopSize), job.spectrum);
+
+                    float* magnitudes = chunk.output + ((juce::int64) f * chunk.numChannels + c) * chunk.numBins;
+                    for (int b = 0; b < chunk.numBins; ++b) {
+                        magnitudes[b] = std::abs(job.spectrum[b]);
+                    }
+                }
+            }
+        }
+    };
+
+    // Writes the header, and extends the file to its full size so it can be mapped
+    static bool createOutputFile(const juce::File& file, const Header& header, juce::int64 totalBytes) {
+        if (file.exists() && !file.deleteFile()) return false;
+
+        juce::FileOutputStream out (file);
+        if (!out.openedOk()) return false;
+
+        char padded[headerSize] = {};
+        std::memcpy(padded, &header, sizeof(Header));
+        if (!out.write(padded, headerSize)) return false;
+
+        if (totalBytes > headerSize) {
+            if (!out.setPosition(totalBytes - 1) || !out.writeByte(0)) return false;
+        }
+        out.flush();
+        return !out.getStatus().failed();
+    }
+};
+
+} // namespace imagiro
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dsp/spectral.h"
+
+namespace imagiro {
+
+// Small persistent thread pool for fanning short, per-channel jobs out from the audio thread
+// (e.g. STFT::setExecutor()). The calling thread takes part in each job too.
+//
+// Idle workers spin for a while before parking on a condition variable, so back-to-back jobs
+// (one per STFT hop) don't pay for a wake-up each time.
+class WorkerPool : public signalsmith::spectral::Executor {
+public:
+    explicit WorkerPool(int numWorkers, int spinIterations = 20000) : spinIterations(spinIterations) {
+        for (int i = 0; i < numWorkers; ++i) {
+            threads.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool() override {
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            quit = true;
+        }
+        parkCondition.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    int getNumWorkers() const { return (int) threads.size(); }
+
+    // Runs task(context, i) for every i in [0, count), returning once they've all finished.
+    // Not re-entrant: only one thread should call this at a time.
+    void run(int count, Task task, void* context) override {
+        if (count <= 0) return;
+        if (threads.empty() || count == 1) {
+            for (int i = 0; i < count; ++i) task(context, i);
+            return;
+        }
+
+        jobTask.store(task, std::memory_order_relaxed);
+        jobContext.store(context, std::memory_order_relaxed);
+        remaining.store(count, std::memory_order_relaxed);
+        uint32_t generation = ++currentGeneration;
+        state.store((uint64_t(generation) << 32) | uint32_t(count));
+
+        if (parkedWorkers.load() > 0) {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            parkCondition.notify_all();
+        }
+
+        while (runOne(generation)) {}
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    // The job generation (high 32 bits) and number of unclaimed tasks (low 32 bits), so that a task
+    // can only be claimed from the job it belongs to. Tasks are claimed from the last index down.
+    std::atomic<uint64_t> state {0};
+    uint32_t currentGeneration = 0;
+    std::atomic<Task> jobTask {nullptr};
+    std::atomic<void*> jobContext {nullptr};
+    std::atomic<int> remaining {0};
+
+    const int spinIterations;
+    std::atomic<int> parkedWorkers {0};
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+    bool quit = false;
+
+    std::vector<std::thread> threads;
+
+    static uint32_t generationOf(uint64_t s) { return uint32_t(s >> 32); }
+
+    // Claims and runs one task from the given job, returning false if there are none left
+    bool runOne(uint32_t generation) {
+        uint64_t s = state.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t unclaimed = uint32_t(s);
+            if (generationOf(s) != generation || unclaimed == 0) return false;
+            if (!state.compare_exchange_weak(s, s - 1, std::memory_order_acq_rel)) continue;
+
+            // Until our claimed task finishes, the job can't complete, so its details can't change
+            int index = int(unclaimed - 1);
+
+            jobTask.load(std::memory_order_relaxed)(jobContext.load(std::memory_order_relaxed), index);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    void workerLoop() {
+        uint32_t seenGeneration = 0;
+        while (true) {
+            uint32_t generation = generationOf(state.load(std::memory_order_acquire));
+            for (int spin = 0; generation == seenGeneration && spin < spinIterations; ++spin) {
+                generation = generationOf(state.load(std::memory_order_acquire));
+            }
+
+            if (generation == seenGeneration) {
+                std::unique_lock<std::mutex> lock(parkMutex);
+                ++parkedWorkers;
+                parkCondition.wait(lock, [&] {
+                    return quit || generationOf(state.load()) != seenGeneration;
+                });
+                --parkedWorkers;
+                if (quit) return;
+                continue;
+            }
+
+            seenGeneration = generation;
+            while (runOne(generation)) {}
+        }
+    }
+};
+
+} // namespace imagiro
@@ -0,0 +1,221 @@
+#include "./common.h"
+
+#ifndef SIGNALSMITH_DSP_CONVOLUTION_H
+#define SIGNALSMITH_DSP_CONVOLUTION_H
+
+#include "./perf.h"
+#include "./fft.h"
+
+#include <vector>
+#include <complex>
+#include <algorithm>
+
+namespace signalsmith {
+namespace convolution {
+	/**	@defgroup Convolution Convolution
+		@brief FFT-based convolution with (long) impulse responses
+
+		@{
+		@file
+	*/
+
+	/** @brief Uniformly-partitioned overlap-save convolver, with an impulse-response matrix
+
+		The impulse responses are split into partitions of `blockSize`, and each pair of input/output channels has its own IR.  The spectra of past input blocks are kept in a frequency-domain delay line, so each input block is only transformed once, however many outputs/partitions it contributes to.
+
+		There is no latency: the current (partial) block is re-transformed on every `.process()` call, so calling it with exactly `blockSize` samples at a time is the most efficient.  All memory is allocated in `.resize()`, so neither `.setIr()` nor `.process()` allocate.
+	*/
+	template<typename Sample>
+	class UniformConvolver {
+		using Complex = std::complex<Sample>;
+		signalsmith::fft::RealFFT<Sample> fft;
+
+		int inChannels = 0, outChannels = 0;
+		int _blockSize = 0, partitions = 0;
+		int inputIndex = 0; // position within the current block
+		int fdlIndex = 0; // slot in the frequency-domain delay line for the current block
+
+		// Time-domain input: each channel holds the previous and current block (`2*blockSize`)
+		std::vector<Sample> inputSegments;
+		// Input spectra (`blockSize` bins), indexed by [slot][inChannel]
+		std::vector<Complex> fdl;
+		// IR spectra, indexed by [outChannel][inChannel][partition]
+		std::vector<Complex> irSpectra;
+		std::vector<int> irPartitions;
+		// Summed contributions from past blocks, which only change once per block
+		std::vector<Complex> tailSpectra;
+		std::vector<Complex> outputSpectra;
+		std::vector<Sample> outputSegments;
+		std::vector<Sample> irBuffer;
+
+		Complex * fdlSpectrum(int slot, int inChannel) {
+			return fdl.data() + (slot*inChannels + inChannel)*_blockSize;
+		}
+		Complex * irSpectrum(int outChannel, int inChannel, int partition) {
+			return irSpectra.data() + ((outChannel*inChannels + inChannel)*partitions + partition)*_blockSize;
+		}
+
+		/// Complex multiply-accumulate, written to auto-vectorise (see `perf::mul()`)
+		static void multiplyAccumulate(Complex *sum, const Complex *a, const Complex *b, int bins) {
+			// Bin 0 holds the (real-valued) DC and Nyquist bins, packed together by `RealFFT`
+			Complex dcNyquist = {
+				sum[0].real() + a[0].real()*b[0].real(),
+				sum[0].imag() + a[0].imag()*b[0].imag()
+			};
+			for (int i = 0; i < bins; ++i) {
+				sum[i] += signalsmith::perf::mul(a[i], b[i]);
+			}
+			sum[0] = dcNyquist;
+		}
+
+		void sumTails() {
+			tailSpectra.assign(tailSpectra.size(), 0);
+			for (int o = 0; o < outChannels; ++o) {
+				Complex *tail = tailSpectra.data() + o*_blockSize;
+				for (int i = 0; i < inChannels; ++i) {
+					int irParts = irPartitions[o*inChannels + i];
+					for (int p = 1; p < irParts; ++p) {
+						int slot = (fdlIndex + partitions - p)%partitions;
+						multiplyAccumulate(tail, fdlSpectrum(slot, i), irSpectrum(o, i, p), _blockSize);
+					}
+				}
+			}
+		}
+	public:
+		UniformConvolver() {}
+		UniformConvolver(int inChannels, int outChannels, int blockSize, int maxIrLength) {
+			resize(inChannels, outChannels, blockSize, maxIrLength);
+		}
+
+		/// Allocates everything, and clears the IRs
+		void resize(int nInChannels, int nOutChannels, int blockSize, int maxIrLength) {
+			inChannels = nInChannels;
+			outChannels = nOutChannels;
+			_blockSize = std::max(blockSize, 1);
+			partitions = std::max(1, (maxIrLength + _blockSize - 1)/_blockSize);
+
+			fft.setSize(2*_blockSize);
+			fft.reserveBatch(std::max(inChannels, outChannels));
+
+			inputSegments.assign(inChannels*2*_blockSize, 0);
+			fdl.assign(partitions*inChannels*_blockSize, 0);
+			irSpectra.assign(outChannels*inChannels*partitions*_blockSize, 0);
+			irPartitions.assign(outChannels*inChannels, 0);
+			tailSpectra.assign(outChannels*_blockSize, 0);
+			outputSpectra.assign(outChannels*_blockSize, 0);
+			outputSegments.assign(outChannels*2*_blockSize, 0);
+			irBuffer.assign(2*_blockSize, 0);
+			reset();
+		}
+		/// Clears the input history (but not the IRs)
+		void reset() {
+			inputSegments.assign(inputSegments.size(), 0);
+			fdl.assign(fdl.size(), 0);
+			tailSpectra.assign(tailSpectra.size(), 0);
+			inputIndex = 0;
+			fdlIndex = 0;
+		}
+
+		int blockSize() const {
+			return _blockSize;
+		}
+		int maxIrLength() const {
+			return partitions*_blockSize;
+		}
+		int latency() const {
+			return 0;
+		}
+
+		/** Sets the IR from one input to one output, for any type where `ir[index]` returns samples.
+		The IR is truncated to `.maxIrLength()`.  This doesn't allocate, but it isn't thread-safe with `.process()`. */
+		template<class Data>
+		void setIr(int outChannel, int inChannel, Data &&ir, int irLength) {
+			irLength = std::min(irLength, maxIrLength());
+			int irParts = (irLength + _blockSize - 1)/_blockSize;
+			irPartitions[outChannel*inChannels + inChannel] = irParts;
+
+			// Pre-scaled, so the round-trip through the FFT is unity gain
+			Sample scale = Sample(1)/(2*_blockSize);
+			Sample *padded = irBuffer.data();
+			for (int p = 0; p < partitions; ++p) {
+				Complex *spectrum = irSpectrum(outChannel, inChannel, p);
+				if (p >= irParts) {
+					std::fill(spectrum, spectrum + _blockSize, Complex(0));
+					continue;
+				}
+				int offset = p*_blockSize;
+				for (int i = 0; i < _blockSize; ++i) {
+					padded[i] = (offset + i < irLength) ? ir[offset + i]*scale : 0;
+				}
+				std::fill(padded + _blockSize, padded + 2*_blockSize, Sample(0));
+				fft.fft(padded, spectrum);
+			}
+			// Partitions from before this change are summed with the new IR
+			sumTails();
+		}
+		/// Clears all IRs
+		void clearIrs() {
+			irSpectra.assign(irSpectra.size(), 0);
+			irPartitions.assign(irPartitions.size(), 0);
+			tailSpectra.assign(tailSpectra.size(), 0);
+		}
+
+		/** Convolves `length` samples, for any types where `data[channel][index]` returns samples.
+		The output is replaced, not added to. */
+		template<class Input, class Output>
+		void process(Input &&input, Output &&output, int length) {
+			const int bins = _blockSize, segmentSize = 2*_blockSize;
+			int done = 0;
+			while (done < length) {
+				int count = std::min(length - done, _blockSize - inputIndex);
+
+				// Add the new samples to the current block, and transform all input channels together
+				for (int i = 0; i < inChannels; ++i) {
+					auto &&channel = input[i];
+					Sample *current = inputSegments.data() + i*segmentSize + _blockSize + inputIndex;
+					for (int s = 0; s < count; ++s) {
+						current[s] = channel[done + s];
+					}
+				}
+				fft.fftBatch(inputSegments.data(), fdlSpectrum(fdlIndex, 0), inChannels, segmentSize, bins);
+
+				std::copy(tailSpectra.begin(), tailSpectra.end(), outputSpectra.begin());
+				for (int o = 0; o < outChannels; ++o) {
+					Complex *sum = outputSpectra.data() + o*bins;
+					for (int i = 0; i < inChannels; ++i) {
+						if (irPartitions[o*inChannels + i] > 0) {
+							multiplyAccumulate(sum, fdlSpectrum(fdlIndex, i), irSpectrum(o, i, 0), bins);
+						}
+					}
+				}
+				fft.ifftBatch(outputSpectra.data(), outputSegments.data(), outChannels, bins, segmentSize);
+
+				// Overlap-save: only the second half of each segment is valid
+				for (int o = 0; o < outChannels; ++o) {
+					auto &&channel = output[o];
+					const Sample *valid = outputSegments.data() + o*segmentSize + _blockSize + inputIndex;
+					for (int s = 0; s < count; ++s) {
+						channel[done + s] = valid[s];
+					}
+				}
+
+				done += count;
+				inputIndex += count;
+				if (inputIndex == _blockSize) {
+					// Move the current block to the first half, ready for the next block
+					for (int i = 0; i < inChannels; ++i) {
+						Sample *segment = inputSegments.data() + i*segmentSize;
+						std::copy(segment + _blockSize, segment + segmentSize, segment);
+						std::fill(segment + _blockSize, segment + segmentSize, Sample(0));
+					}
+					inputIndex = 0;
+					fdlIndex = (fdlIndex + 1)%partitions;
+					sumTails();
+				}
+			}
+		}
+	};
+
+/** @} */
+}} // signalsmith::convolution::
+#endif // include guard
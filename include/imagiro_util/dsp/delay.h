@@ -7,6 +7,19 @@
 #include <array>
 #include <cmath> // for std::ceil()
 #include <type_traits>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+#if defined(__linux__)
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	if defined(SYS_memfd_create) && defined(MAP_FIXED)
+#		define SIGNALSMITH_DELAY_MIRRORED
+#	endif
+#endif
 
 #include <complex>
 #include "./fft.h"
@@ -25,6 +38,87 @@ namespace delay {
 		@file
 	*/
 
+	namespace _impl {
+		/** Maps the same (zeroed) memory twice in a row, so that anything running off the end carries on from the start.
+		
+		Uses `memfd_create()`, so this is only available on Linux - elsewhere (or if any of the system calls fail) `.allocate()` returns `false`. */
+		class MirroredMemory {
+			void *pointer = nullptr;
+			size_t size = 0;
+		public:
+			MirroredMemory() {}
+			MirroredMemory(const MirroredMemory &other) = delete;
+			MirroredMemory & operator =(const MirroredMemory &other) = delete;
+			MirroredMemory(MirroredMemory &&other) : pointer(other.pointer), size(other.size) {
+				other.pointer = nullptr;
+				other.size = 0;
+			}
+			MirroredMemory & operator =(MirroredMemory &&other) {
+				std::swap(pointer, other.pointer);
+				std::swap(size, other.size);
+				return *this;
+			}
+			~MirroredMemory() {
+				release();
+			}
+
+			/// The mapping granularity - the size must be a multiple of this
+			static size_t pageSize() {
+#ifdef SIGNALSMITH_DELAY_MIRRORED
+				long page = sysconf(_SC_PAGESIZE);
+				return page > 0 ? size_t(page) : 4096;
+#else
+				return 1;
+#endif
+			}
+
+			/// Allocates `bytes` (a multiple of `pageSize()`), accessible from `.data()` up to `.data() + 2*bytes`
+			bool allocate(size_t bytes) {
+				release();
+#ifdef SIGNALSMITH_DELAY_MIRRORED
+				if (!bytes || bytes%pageSize()) return false;
+				int fd = int(syscall(SYS_memfd_create, "signalsmith-delay", 1u/*MFD_CLOEXEC*/));
+				if (fd < 0) return false;
+				if (ftruncate(fd, off_t(bytes)) != 0) {
+					close(fd);
+					return false;
+				}
+				// Reserve the whole range first, then map the file over both halves
+				void *reserved = mmap(nullptr, 2*bytes, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+				if (reserved == MAP_FAILED) {
+					close(fd);
+					return false;
+				}
+				char *first = (char *)reserved, *second = first + bytes;
+				bool mapped = mmap(first, bytes, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_FIXED, fd, 0) == first
+					&& mmap(second, bytes, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_FIXED, fd, 0) == second;
+				close(fd); // the mappings keep the memory alive
+				if (!mapped) {
+					munmap(reserved, 2*bytes);
+					return false;
+				}
+				pointer = reserved;
+				size = bytes;
+				return true;
+#else
+				(void)bytes;
+				return false;
+#endif
+			}
+			void release() {
+#ifdef SIGNALSMITH_DELAY_MIRRORED
+				if (pointer) munmap(pointer, 2*size);
+#endif
+				pointer = nullptr;
+				size = 0;
+			}
+
+			void * data() const {
+				return pointer;
+			}
+		};
+	}
+
 	/** @brief Single-channel delay buffer
  
 		Access is used with `buffer[]`, relative to the internal read/write position ("head").  This head is moved using `++buffer` (or `buffer += n`), such that `buffer[1] == (buffer + 1)[0]` in a similar way iterators/pointers.
@@ -43,7 +137,10 @@ namespace delay {
 	class Buffer {
 		unsigned bufferIndex;
 		unsigned bufferMask;
+		Sample *bufferData = nullptr; // points into either `buffer` or `mirroredMemory`
 		std::vector<Sample> buffer;
+		_impl::MirroredMemory mirroredMemory;
+		bool mirrored = false, wantsMirrored = false;
 	public:
 		Buffer(int minCapacity=0) {
 			resize(minCapacity);
@@ -58,12 +155,46 @@ namespace delay {
 		void resize(int minCapacity, Sample value=Sample()) {
 			int bufferLength = 1;
 			while (bufferLength < minCapacity) bufferLength *= 2;
-			buffer.assign(bufferLength, value);
 			bufferMask = unsigned(bufferLength - 1);
 			bufferIndex = 0;
+
+			mirrored = false;
+			if (wantsMirrored && std::is_trivially_copyable<Sample>::value) {
+				// Both the length and the sample size are powers of 2, so this only has to reach a single page
+				size_t pageSize = _impl::MirroredMemory::pageSize();
+				while (bufferLength*sizeof(Sample) < pageSize && (pageSize%sizeof(Sample)) == 0) bufferLength *= 2;
+				if (bufferLength*sizeof(Sample)%pageSize == 0 && mirroredMemory.allocate(bufferLength*sizeof(Sample))) {
+					mirrored = true;
+					bufferMask = unsigned(bufferLength - 1);
+					buffer.clear();
+					buffer.shrink_to_fit();
+					bufferData = (Sample *)mirroredMemory.data();
+					std::fill(bufferData, bufferData + bufferLength, value);
+					return;
+				}
+			}
+			mirroredMemory.release();
+			buffer.assign(bufferLength, value);
+			bufferData = buffer.data();
 		}
 		void reset(Sample value=Sample()) {
-			buffer.assign(buffer.size(), value);
+			std::fill(bufferData, bufferData + bufferMask + 1, value);
+		}
+
+		/** Switches to (or away from) a mirrored backing store, where the same memory is mapped twice in a row.  Any span of up to `.capacity()` samples is then contiguous in memory, so block reads/writes don't need any wrap-around logic.
+		
+		This is only supported on Linux (for trivially-copyable samples), and returns whether the buffer is now mirrored.  The capacity may be rounded up to fill a whole memory page.  The buffer is resized (and cleared) either way. */
+		bool setMirrored(bool useMirrored, Sample value=Sample()) {
+			wantsMirrored = useMirrored;
+			resize(int(bufferMask + 1), value);
+			return mirrored;
+		}
+		bool isMirrored() const {
+			return mirrored;
+		}
+		/// The actual (power-of-2) number of samples held
+		int capacity() const {
+			return int(bufferMask + 1);
 		}
 
 		/// Holds a view for a particular position in the buffer
@@ -83,24 +214,55 @@ namespace delay {
 			}
 			
 			CSample & operator[](int offset) {
-				return buffer->buffer[(bufferIndex + (unsigned)offset)&buffer->bufferMask];
+				return buffer->bufferData[(bufferIndex + (unsigned)offset)&buffer->bufferMask];
 			}
 			const Sample & operator[](int offset) const {
-				return buffer->buffer[(bufferIndex + (unsigned)offset)&buffer->bufferMask];
+				return buffer->bufferData[(bufferIndex + (unsigned)offset)&buffer->bufferMask];
 			}
 
-			/// Write data into the buffer
+			/// Pointer to the sample at this position, valid for `.contiguousLength()` samples
+			CSample * data() const {
+				return buffer->bufferData + (bufferIndex&buffer->bufferMask);
+			}
+			/// Number of samples (from this position) before the buffer wraps around - or the whole capacity, if it's mirrored
+			int contiguousLength() const {
+				if (buffer->mirrored) return int(buffer->bufferMask + 1);
+				return int(buffer->bufferMask + 1 - (bufferIndex&buffer->bufferMask));
+			}
+
+			/// Raw access to the (power-of-2 sized) storage: `view[i]` is `data[(index + i)&mask]`
+			struct Storage {
+				CSample *data;
+				unsigned index, mask;
+			};
+			Storage storage() const {
+				return {buffer->bufferData, bufferIndex, buffer->bufferMask};
+			}
+
+			/// Write data into the buffer, in contiguous spans (a single span if it's mirrored)
 			template<typename Data>
 			void write(Data &&data, int length) {
-				for (int i = 0; i < length; ++i) {
-					(*this)[i] = data[i];
+				for (int done = 0; done < length;) {
+					View position(*this, done);
+					CSample *span = position.data();
+					int count = std::min(length - done, position.contiguousLength());
+					for (int i = 0; i < count; ++i) {
+						span[i] = data[done + i];
+					}
+					done += count;
 				}
 			}
-			/// Read data out from the buffer
+			/// Read data out from the buffer, in contiguous spans (a single span if it's mirrored)
 			template<typename Data>
 			void read(int length, Data &&data) const {
-				for (int i = 0; i < length; ++i) {
-					data[i] = (*this)[i];
+				for (int done = 0; done < length;) {
+					View position(*this, done);
+					const Sample *span = position.data();
+					int count = std::min(length - done, position.contiguousLength());
+					for (int i = 0; i < count; ++i) {
+						data[done + i] = span[i];
+					}
+					done += count;
 				}
 			}
 
@@ -125,25 +287,21 @@ namespace delay {
 		}
 
 		Sample & operator[](int offset) {
-			return buffer[(bufferIndex + (unsigned)offset)&bufferMask];
+			return bufferData[(bufferIndex + (unsigned)offset)&bufferMask];
 		}
 		const Sample & operator[](int offset) const {
-			return buffer[(bufferIndex + (unsigned)offset)&bufferMask];
+			return bufferData[(bufferIndex + (unsigned)offset)&bufferMask];
 		}
 
 		/// Write data into the buffer
 		template<typename Data>
 		void write(Data &&data, int length) {
-			for (int i = 0; i < length; ++i) {
-				(*this)[i] = data[i];
-			}
+			view().write(data, length);
 		}
 		/// Read data out from the buffer
 		template<typename Data>
 		void read(int length, Data &&data) const {
-			for (int i = 0; i < length; ++i) {
-				data[i] = (*this)[i];
-			}
+			view().read(length, data);
 		}
 		
 		Buffer & operator ++() {
@@ -212,6 +370,10 @@ namespace delay {
 		void reset(Sample value=Sample()) {
 			buffer.reset(value);
 		}
+		/// Uses a mirrored backing store (see `Buffer::setMirrored()`) - the channel stride is unchanged
+		bool setMirrored(bool mirrored, Sample value=Sample()) {
+			return buffer.setMirrored(mirrored, value);
+		}
 
 		/// A reference-like multi-channel result for a particular sample index
 		template<bool isConst>
@@ -342,6 +504,80 @@ namespace delay {
 		}
 	};
 	
+	/** @brief Multi-channel delay buffer, with the channels interleaved
+
+		Each position holds a contiguous frame of `.channels()` samples, so `buffer.frame(-10)` points to all the channels at that index.  Reading or writing every channel at once is then a single contiguous span, instead of one sample per channel, `stride` apart (as in `MultiBuffer`).
+		
+		The head is moved in the same way as `Buffer`, and the capacity is similarly rounded up to a power of 2.
+	*/
+	template<typename Sample>
+	class InterleavedBuffer {
+		int _channels = 0;
+		unsigned bufferIndex = 0;
+		unsigned bufferMask = 0;
+		std::vector<Sample> buffer;
+	public:
+		InterleavedBuffer(int channels=0, int minCapacity=0) {
+			resize(channels, minCapacity);
+		}
+		// We shouldn't accidentally copy a delay buffer
+		InterleavedBuffer(const InterleavedBuffer &other) = delete;
+		InterleavedBuffer & operator =(const InterleavedBuffer &other) = delete;
+		// But moving one is fine
+		InterleavedBuffer(InterleavedBuffer &&other) = default;
+		InterleavedBuffer & operator =(InterleavedBuffer &&other) = default;
+
+		void resize(int nChannels, int minCapacity, Sample value=Sample()) {
+			int bufferLength = 1;
+			while (bufferLength < minCapacity) bufferLength *= 2;
+			_channels = nChannels;
+			buffer.assign(bufferLength*_channels, value);
+			bufferMask = unsigned(bufferLength - 1);
+			bufferIndex = 0;
+		}
+		void reset(Sample value=Sample()) {
+			buffer.assign(buffer.size(), value);
+		}
+		int channels() const {
+			return _channels;
+		}
+
+		/// Pointer to the `.channels()` samples at a particular index
+		Sample * frame(int offset) {
+			return buffer.data() + ((bufferIndex + (unsigned)offset)&bufferMask)*unsigned(_channels);
+		}
+		const Sample * frame(int offset) const {
+			return buffer.data() + ((bufferIndex + (unsigned)offset)&bufferMask)*unsigned(_channels);
+		}
+
+		/// Raw access to the storage: channel `c` of `frame(i)` is `data[((index + i)&mask)*channels + c]`
+		struct Storage {
+			const Sample *data;
+			unsigned index, mask;
+			int channels;
+		};
+		Storage storage() const {
+			return {buffer.data(), bufferIndex, bufferMask, _channels};
+		}
+
+		InterleavedBuffer & operator ++() {
+			++bufferIndex;
+			return *this;
+		}
+		InterleavedBuffer & operator +=(int i) {
+			bufferIndex += (unsigned)i;
+			return *this;
+		}
+		InterleavedBuffer & operator --() {
+			--bufferIndex;
+			return *this;
+		}
+		InterleavedBuffer & operator -=(int i) {
+			bufferIndex -= (unsigned)i;
+			return *this;
+		}
+	};
+	
 	/** \defgroup Interpolators Interpolators
 		\ingroup Delay
 		@{ */
@@ -369,6 +605,14 @@ namespace delay {
 			Sample a = data[0], b = data[1];
 			return a + fractional*(b - a);
 		}
+
+		/// Block version of `.fractional()` (see `Reader::readBlock()`)
+		static void fractionalBlock(const Sample *data, unsigned mask, const unsigned *indices, const Sample *fractions, Sample *output, int count) {
+			for (int i = 0; i < count; ++i) {
+				Sample a = data[indices[i]&mask], b = data[(indices[i] - 1)&mask];
+				output[i] = a + fractions[i]*(b - a);
+			}
+		}
 	};
 	/// Spline cubic interpolator
 	/// \diagram{delay-random-access-cubic.svg,aliasing and maximum amplitude/delay errors for different input frequencies}
@@ -387,6 +631,20 @@ namespace delay {
 			Sample k2 = cbDiff - k3 - k1;
 			return b + fractional*(k1 + fractional*(k2 + fractional*k3)); // 16 ops total, not including the indexing
 		}
+
+		/// Block version of `.fractional()` (see `Reader::readBlock()`)
+		static void fractionalBlock(const Sample *data, unsigned mask, const unsigned *indices, const Sample *fractions, Sample *output, int count) {
+			for (int i = 0; i < count; ++i) {
+				unsigned index = indices[i];
+				Sample a = data[index&mask], b = data[(index - 1)&mask], c = data[(index - 2)&mask], d = data[(index - 3)&mask];
+				Sample cbDiff = c - b;
+				Sample k1 = (c - a)*0.5;
+				Sample k3 = k1 + (d - b)*0.5 - cbDiff*2;
+				Sample k2 = cbDiff - k3 - k1;
+				Sample fractional = fractions[i];
+				output[i] = b + fractional*(k1 + fractional*(k2 + fractional*k3));
+			}
+		}
 	};
 
 	// Efficient Algorithms and Structures for Fractional Delay Filtering Based on Lagrange Interpolation
@@ -465,102 +723,314 @@ namespace delay {
 	template<typename Sample>
 	using InterpolatorLagrange19 = InterpolatorLagrangeN<Sample, 19>;
 
+	namespace _kaiser_impl {
+		// Dot-products for `InterpolatorKaiserSincN`, where `length` is a multiple of 8
+		template<typename Sample>
+		Sample blendedDotScalar(const Sample *data, const Sample *coeffLow, const Sample *coeffHigh, int length, Sample fraction) {
+			Sample sumLow = 0, sumHigh = 0;
+			for (int i = 0; i < length; ++i) {
+				sumLow += data[i]*coeffLow[i];
+				sumHigh += data[i]*coeffHigh[i];
+			}
+			return sumLow + (sumHigh - sumLow)*fraction;
+		}
+		template<typename Sample>
+		Sample dotScalar(const Sample *data, const Sample *coeffs, int length) {
+			Sample sum = 0;
+			for (int i = 0; i < length; ++i) {
+				sum += data[i]*coeffs[i];
+			}
+			return sum;
+		}
+
+#if defined(SIGNALSMITH_FFT_SSE2) || defined(SIGNALSMITH_FFT_NEON)
+		// Uses the SIMD packs from the FFT, with one copy per instruction set (as in `fft.h`)
+#define SIGNALSMITH_DELAY_SIMD_DOT(TARGET) \
+		template<class Pack, typename Sample> \
+		SIGNALSMITH_INLINE TARGET Sample sumLanes(typename Pack::V v) { \
+			constexpr int width = int(Pack::width*2); \
+			Sample lanes[width]; \
+			Pack::storeReals(lanes, v); \
+			Sample sum = lanes[0]; \
+			for (int i = 1; i < width; ++i) sum += lanes[i]; \
+			return sum; \
+		} \
+		template<class Pack, typename Sample> \
+		TARGET Sample blendedDot(const Sample *data, const Sample *coeffLow, const Sample *coeffHigh, int length, Sample fraction) { \
+			using V = typename Pack::V; \
+			constexpr int width = int(Pack::width*2); \
+			V x = Pack::loadReals(data); \
+			V sumLow = Pack::mul(x, Pack::loadReals(coeffLow)), sumHigh = Pack::mul(x, Pack::loadReals(coeffHigh)); \
+			for (int i = width; i < length; i += width) { \
+				x = Pack::loadReals(data + i); \
+				sumLow = Pack::add(sumLow, Pack::mul(x, Pack::loadReals(coeffLow + i))); \
+				sumHigh = Pack::add(sumHigh, Pack::mul(x, Pack::loadReals(coeffHigh + i))); \
+			} \
+			Sample low = sumLanes<Pack, Sample>(sumLow), high = sumLanes<Pack, Sample>(sumHigh); \
+			return low + (high - low)*fraction; \
+		} \
+		template<class Pack, typename Sample> \
+		TARGET Sample dot(const Sample *data, const Sample *coeffs, int length) { \
+			using V = typename Pack::V; \
+			constexpr int width = int(Pack::width*2); \
+			V sum = Pack::mul(Pack::loadReals(data), Pack::loadReals(coeffs)); \
+			for (int i = width; i < length; i += width) { \
+				sum = Pack::add(sum, Pack::mul(Pack::loadReals(data + i), Pack::loadReals(coeffs + i))); \
+			} \
+			return sumLanes<Pack, Sample>(sum); \
+		}
+		namespace _simd_native {
+			SIGNALSMITH_DELAY_SIMD_DOT()
+		}
+#	ifdef SIGNALSMITH_FFT_AVX2
+		namespace _simd_avx2 {
+			SIGNALSMITH_DELAY_SIMD_DOT(SIGNALSMITH_FFT_AVX2)
+		}
+#	endif
+#undef SIGNALSMITH_DELAY_SIMD_DOT
+#endif
+
+		template<typename Sample>
+		struct DotKernels {
+			Sample (*blendedDot)(const Sample *data, const Sample *coeffLow, const Sample *coeffHigh, int length, Sample fraction) = blendedDotScalar<Sample>;
+			Sample (*dot)(const Sample *data, const Sample *coeffs, int length) = dotScalar<Sample>;
+
+#if defined(SIGNALSMITH_FFT_SSE2) || defined(SIGNALSMITH_FFT_NEON)
+			template<class Pack>
+			static DotKernels native() {
+				DotKernels result;
+				result.blendedDot = _simd_native::blendedDot<Pack, Sample>;
+				result.dot = _simd_native::dot<Pack, Sample>;
+				return result;
+			}
+#endif
+#ifdef SIGNALSMITH_FFT_AVX2
+			template<class Pack>
+			static DotKernels avx2() {
+				DotKernels result;
+				result.blendedDot = _simd_avx2::blendedDot<Pack, Sample>;
+				result.dot = _simd_avx2::dot<Pack, Sample>;
+				return result;
+			}
+#endif
+		};
+		template<typename Sample>
+		DotKernels<Sample> chooseDotKernels(Sample *) {
+			return {};
+		}
+#ifdef SIGNALSMITH_FFT_SSE2
+		inline DotKernels<float> chooseDotKernels(float *) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (::signalsmith::fft::_fft_impl::cpuSupportsAvx2()) return DotKernels<float>::avx2<::signalsmith::fft::_fft_impl::PackAvx2Float>();
+#	endif
+			return DotKernels<float>::native<::signalsmith::fft::_fft_impl::PackSse2Float>();
+		}
+		inline DotKernels<double> chooseDotKernels(double *) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (::signalsmith::fft::_fft_impl::cpuSupportsAvx2()) return DotKernels<double>::avx2<::signalsmith::fft::_fft_impl::PackAvx2Double>();
+#	endif
+			return DotKernels<double>::native<::signalsmith::fft::_fft_impl::PackSse2Double>();
+		}
+#elif defined(SIGNALSMITH_FFT_NEON)
+		inline DotKernels<float> chooseDotKernels(float *) {
+			return DotKernels<float>::native<::signalsmith::fft::_fft_impl::PackNeonFloat>();
+		}
+		inline DotKernels<double> chooseDotKernels(double *) {
+			return DotKernels<double>::native<::signalsmith::fft::_fft_impl::PackNeonDouble>();
+		}
+#endif
+	}
+
 	/** Fixed-size Kaiser-windowed sinc interpolation.
 	\diagram{interpolator-KaiserSincN.svg,aliasing and amplitude/delay errors for different sizes}
 	If `minimumPhase` is enabled, a minimum-phase version of the kernel is used:
 	\diagram{interpolator-KaiserSincN-min.svg,aliasing and amplitude/delay errors for minimum-phase mode}
+
+	The coefficient rows are stored oldest-sample-first, aligned and zero-padded to a multiple of 8.  In block reads (`Reader::readBlock()`) this lets each output be computed straight from the delay buffer, with both dot-products in one SIMD pass (SSE2/AVX2/NEON, with AVX2 chosen at runtime).  These can differ from `.fractional()` by rounding errors.  For a delay which stays the same for the whole block, the coefficients are blended once, and each sample only needs a single dot-product.
 	*/
 	template<typename Sample, int n, bool minimumPhase=false>
 	struct InterpolatorKaiserSincN {
 		static constexpr int inputLength = n;
 		static constexpr Sample latency = minimumPhase ? 0 : (n*Sample(0.5) - 1);
 
-		int subSampleSteps;
-		std::vector<Sample> coefficients;
-		
-		InterpolatorKaiserSincN() : InterpolatorKaiserSincN(0.5 - 0.45/std::sqrt(n)) {}
-		InterpolatorKaiserSincN(double passFreq) : InterpolatorKaiserSincN(passFreq, 1 - passFreq) {}
-		InterpolatorKaiserSincN(double passFreq, double stopFreq) {
-			subSampleSteps = 2*n; // Heuristic again.  Really it depends on the bandwidth as well.
-			double kaiserBandwidth = (stopFreq - passFreq)*(n + 1.0/subSampleSteps);
-			kaiserBandwidth += 1.25/kaiserBandwidth; // We want to place the first zero, but (because using this to window a sinc essentially integrates it in the freq-domain), our ripples (and therefore zeroes) are out of phase.  This is a heuristic fix.
-			double sincScale = M_PI*(passFreq + stopFreq);
-
-			double centreIndex = n*subSampleSteps*0.5, scaleFactor = 1.0/subSampleSteps;
-			std::vector<Sample> windowedSinc(subSampleSteps*n + 1);
-			
-			::signalsmith::windows::Kaiser::withBandwidth(kaiserBandwidth, false).fill(windowedSinc, windowedSinc.size());
-
-			for (size_t i = 0; i < windowedSinc.size(); ++i) {
-				double x = (i - centreIndex)*scaleFactor;
-				int intX = std::round(x);
-				if (intX != 0 && std::abs(x - intX) < 1e-6) {
-					// Exact 0s
-					windowedSinc[i] = 0;
-				} else if (std::abs(x) > 1e-6) {
-					double p = x*sincScale;
-					windowedSinc[i] *= std::sin(p)/p;
-				}
-			}
-			
-			if (minimumPhase) {
-				signalsmith::fft::FFT<Sample> fft(windowedSinc.size()*2, 1);
-				windowedSinc.resize(fft.size(), 0);
-				std::vector<std::complex<Sample>> spectrum(fft.size());
-				std::vector<std::complex<Sample>> cepstrum(fft.size());
-				fft.fft(windowedSinc, spectrum);
-				for (size_t i = 0; i < fft.size(); ++i) {
-					spectrum[i] = std::log(std::abs(spectrum[i]) + 1e-30);
-				}
-				fft.fft(spectrum, cepstrum);
-				for (size_t i = 1; i < fft.size()/2; ++i) {
-					cepstrum[i] *= 0;
-				}
-				for (size_t i = fft.size()/2 + 1; i < fft.size(); ++i) {
-					cepstrum[i] *= 2;
-				}
-				Sample scaling = Sample(1)/fft.size();
-				fft.ifft(cepstrum, spectrum);
+		static constexpr int subSampleSteps = 2*n; // Heuristic again.  Really it depends on the bandwidth as well.
+		/// Coefficient rows are padded (at the start) to this length
+		static constexpr int rowStride = (n + 7)/8*8;
+
+		/// Immutable coefficients, shared between all interpolators with the same parameters (see `.table`)
+		struct Table {
+			signalsmith::perf::AlignedVector<Sample> coefficients;
+			_kaiser_impl::DotKernels<Sample> kernels = _kaiser_impl::chooseDotKernels((Sample *)nullptr);
+
+			Table(const std::pair<double, double> &passStopFreqs) {
+				double passFreq = passStopFreqs.first, stopFreq = passStopFreqs.second;
+				double kaiserBandwidth = (stopFreq - passFreq)*(n + 1.0/subSampleSteps);
+				kaiserBandwidth += 1.25/kaiserBandwidth; // We want to place the first zero, but (because using this to window a sinc essentially integrates it in the freq-domain), our ripples (and therefore zeroes) are out of phase.  This is a heuristic fix.
+				double sincScale = M_PI*(passFreq + stopFreq);
+
+				double centreIndex = n*subSampleSteps*0.5, scaleFactor = 1.0/subSampleSteps;
+				std::vector<Sample> windowedSinc(subSampleSteps*n + 1);
+				
+				::signalsmith::windows::Kaiser::withBandwidth(kaiserBandwidth, false).fill(windowedSinc, windowedSinc.size());
 
-				for (size_t i = 0; i < fft.size(); ++i) {
-					Sample phase = spectrum[i].imag()*scaling;
-					Sample mag = std::exp(spectrum[i].real()*scaling);
-					spectrum[i] = {mag*std::cos(phase), mag*std::sin(phase)};
-				}
-				fft.ifft(spectrum, cepstrum);
-				windowedSinc.resize(subSampleSteps*n + 1);
-				windowedSinc.shrink_to_fit();
 				for (size_t i = 0; i < windowedSinc.size(); ++i) {
-					windowedSinc[i] = cepstrum[i].real()*scaling;
+					double x = (i - centreIndex)*scaleFactor;
+					int intX = std::round(x);
+					if (intX != 0 && std::abs(x - intX) < 1e-6) {
+						// Exact 0s
+						windowedSinc[i] = 0;
+					} else if (std::abs(x) > 1e-6) {
+						double p = x*sincScale;
+						windowedSinc[i] *= std::sin(p)/p;
+					}
 				}
-			}
-			
-			// Re-order into FIR fractional-delay blocks
-			coefficients.resize(n*(subSampleSteps + 1));
-			for (int k = 0; k <= subSampleSteps; ++k) {
-				for (int i = 0; i < n; ++i) {
-					coefficients[k*n + i] = windowedSinc[(subSampleSteps - k) + i*subSampleSteps];
+				
+				if (minimumPhase) {
+					signalsmith::fft::FFT<Sample> fft(windowedSinc.size()*2, 1);
+					windowedSinc.resize(fft.size(), 0);
+					std::vector<std::complex<Sample>> spectrum(fft.size());
+					std::vector<std::complex<Sample>> cepstrum(fft.size());
+					fft.fft(windowedSinc, spectrum);
+					for (size_t i = 0; i < fft.size(); ++i) {
+						spectrum[i] = std::log(std::abs(spectrum[i]) + 1e-30);
+					}
+					fft.fft(spectrum, cepstrum);
+					for (size_t i = 1; i < fft.size()/2; ++i) {
+						cepstrum[i] *= 0;
+					}
+					for (size_t i = fft.size()/2 + 1; i < fft.size(); ++i) {
+						cepstrum[i] *= 2;
+					}
+					Sample scaling = Sample(1)/fft.size();
+					fft.ifft(cepstrum, spectrum);
+
+					for (size_t i = 0; i < fft.size(); ++i) {
+						Sample phase = spectrum[i].imag()*scaling;
+						Sample mag = std::exp(spectrum[i].real()*scaling);
+						spectrum[i] = {mag*std::cos(phase), mag*std::sin(phase)};
+					}
+					fft.ifft(spectrum, cepstrum);
+					windowedSinc.resize(subSampleSteps*n + 1);
+					windowedSinc.shrink_to_fit();
+					for (size_t i = 0; i < windowedSinc.size(); ++i) {
+						windowedSinc[i] = cepstrum[i].real()*scaling;
+					}
+				}
+				
+				// Re-order into FIR fractional-delay blocks, reversed so that the last entry in each row is for the most recent input
+				coefficients.assign(rowStride*(subSampleSteps + 1), 0);
+				for (int k = 0; k <= subSampleSteps; ++k) {
+					Sample *row = coefficients.data() + (k + 1)*rowStride - 1;
+					for (int i = 0; i < n; ++i) {
+						row[-i] = windowedSinc[(subSampleSteps - k) + i*subSampleSteps];
+					}
 				}
 			}
+		};
+		std::shared_ptr<const Table> table;
+
+		InterpolatorKaiserSincN() : table(defaultTable()) {}
+		InterpolatorKaiserSincN(double passFreq) : InterpolatorKaiserSincN(passFreq, 1 - passFreq) {}
+		InterpolatorKaiserSincN(double passFreq, double stopFreq) : table(SharedTables::get({passFreq, stopFreq})) {}
+
+		/// The `subSampleSteps + 1` coefficient rows, each `rowStride` long (see above for the layout)
+		const Sample * coefficients() const {
+			return table->coefficients.data();
+		}
+	private:
+		using SharedTables = signalsmith::fft::_fft_impl::SharedTables<Table, std::pair<double, double>>;
+		static const std::shared_ptr<const Table> & defaultTable() {
+			// Only looked up once, so default construction just copies a pointer
+			static const std::shared_ptr<const Table> table = SharedTables::get({defaultPassFreq(), 1 - defaultPassFreq()});
+			return table;
 		}
+		static double defaultPassFreq() {
+			return 0.5 - 0.45/std::sqrt(n);
+		}
+	public:
 		
 		template<class Data>
 		Sample fractional(const Data &data, Sample fractional) const {
-			Sample subSampleDelay = fractional*subSampleSteps;
-			int lowIndex = subSampleDelay;
-			if (lowIndex >= subSampleSteps) lowIndex = subSampleSteps - 1;
-			Sample subSampleFractional = subSampleDelay - lowIndex;
-			int highIndex = lowIndex + 1;
-			
+			Sample subSampleFractional;
+			const Sample *coeffLow = coefficientRows(fractional, subSampleFractional) + rowStride - 1;
+			const Sample *coeffHigh = coeffLow + rowStride;
+
 			Sample sumLow = 0, sumHigh = 0;
-			const Sample *coeffLow = coefficients.data() + lowIndex*n;
-			const Sample *coeffHigh = coefficients.data() + highIndex*n;
 			for (int i = 0; i < n; ++i) {
-				sumLow += data[i]*coeffLow[i];
-				sumHigh += data[i]*coeffHigh[i];
+				sumLow += data[i]*coeffLow[-i];
+				sumHigh += data[i]*coeffHigh[-i];
 			}
 			return sumLow + (sumHigh - sumLow)*subSampleFractional;
 		}
+
+		/// Block version of `.fractional()` (see `Reader::readBlock()`)
+		void fractionalBlock(const Sample *data, unsigned mask, const unsigned *indices, const Sample *fractions, Sample *output, int count) const {
+			if (rowStride < 16) {
+				// Too short for the SIMD setup to pay off
+				for (int b = 0; b < count; ++b) {
+					output[b] = fractional(MaskedInput{data, mask, indices[b]}, fractions[b]);
+				}
+				return;
+			}
+			alignas(64) Sample wrapped[rowStride];
+			for (int b = 0; b < count; ++b) {
+				Sample subSampleFractional;
+				const Sample *coeffLow = coefficientRows(fractions[b], subSampleFractional);
+				const Sample *input = inputWindow(data, mask, indices[b], wrapped);
+				output[b] = table->kernels.blendedDot(input, coeffLow, coeffLow + rowStride, rowStride, subSampleFractional);
+			}
+		}
+
+		/// The weight for each input `data[i]`, where `.fractional()` is their weighted sum (see `InterleavedDelay`)
+		void fractionalWeights(Sample fraction, Sample *weights) const {
+			Sample subSampleFractional;
+			const Sample *coeffLow = coefficientRows(fraction, subSampleFractional) + rowStride - 1;
+			const Sample *coeffHigh = coeffLow + rowStride;
+			for (int i = 0; i < n; ++i) {
+				weights[i] = coeffLow[-i] + (coeffHigh[-i] - coeffLow[-i])*subSampleFractional;
+			}
+		}
+
+		/// Fixed-delay block version of `.fractional()` (see `Reader::readBlock()`), where the indices would be `firstIndex + b`
+		void fractionalFixedBlock(const Sample *data, unsigned mask, unsigned firstIndex, Sample fraction, Sample *output, int count) const {
+			alignas(64) Sample blended[rowStride];
+			Sample subSampleFractional;
+			const Sample *coeffLow = coefficientRows(fraction, subSampleFractional), *coeffHigh = coeffLow + rowStride;
+			for (int i = 0; i < rowStride; ++i) {
+				blended[i] = coeffLow[i] + (coeffHigh[i] - coeffLow[i])*subSampleFractional;
+			}
+
+			alignas(64) Sample wrapped[rowStride];
+			for (int b = 0; b < count; ++b) {
+				const Sample *input = inputWindow(data, mask, firstIndex + unsigned(b), wrapped);
+				output[b] = table->kernels.dot(input, blended, rowStride);
+			}
+		}
+	private:
+		struct MaskedInput {
+			const Sample *data;
+			unsigned mask, index;
+			Sample operator [](int i) const {
+				return data[(index - unsigned(i))&mask];
+			}
+		};
+		// Returns the lower of the two coefficient rows to blend between (the other is `rowStride` later)
+		const Sample * coefficientRows(Sample fractional, Sample &subSampleFractional) const {
+			Sample subSampleDelay = fractional*subSampleSteps;
+			int lowIndex = subSampleDelay;
+			if (lowIndex >= subSampleSteps) lowIndex = subSampleSteps - 1;
+			subSampleFractional = subSampleDelay - lowIndex;
+			return table->coefficients.data() + lowIndex*rowStride;
+		}
+		// The `rowStride` inputs ending at `index`, read directly from the buffer unless they wrap around
+		static const Sample * inputWindow(const Sample *data, unsigned mask, unsigned index, Sample *wrapped) {
+			unsigned start = (index - unsigned(rowStride - 1))&mask;
+			if (start + rowStride <= mask + 1) return data + start;
+			for (int i = 0; i < rowStride; ++i) {
+				wrapped[i] = data[(start + unsigned(i))&mask];
+			}
+			return wrapped;
+		}
 	};
 
 	template<typename Sample>
@@ -605,6 +1075,76 @@ namespace delay {
 			};
 			return Super::fractional(Flipped{buffer - startIndex}, remainder);
 		}
+
+		/** Reads a block of samples, each with its own delay.
+		`view` is the position of the last sample in the block, so `output[i]` is the same as `.read(view - (length - 1 - i), delays[i])`.
+
+		The buffer wrap-around is handled by masking the indices, so there are no branches in the inner loops.  Interpolators can provide a `.fractionalBlock()` which works on those (masked) indices directly, otherwise this uses `.fractional()` for each sample. */
+		template<class View>
+		void readBlock(const View &view, const Sample *delays, Sample *output, int length) const {
+			constexpr int maxCount = 64;
+			unsigned indices[maxCount];
+			Sample fractions[maxCount];
+
+			auto storage = view.storage();
+			for (int start = 0; start < length; start += maxCount) {
+				int count = std::min(length - start, maxCount);
+				unsigned firstIndex = storage.index + unsigned(start - (length - 1));
+				for (int i = 0; i < count; ++i) {
+					Sample delaySamples = delays[start + i];
+					int startIndex = delaySamples;
+					fractions[i] = delaySamples - startIndex;
+					indices[i] = firstIndex + unsigned(i) - unsigned(startIndex);
+				}
+				readFractionalBlock(static_cast<const Super &>(*this), storage.data, storage.mask, indices, fractions, output + start, count, 0);
+			}
+		}
+		/** Reads a block of samples, all with the same delay.
+		This is the same as above (using `.fractionalFixedBlock()` if the interpolator has one), but the interpolator only needs to prepare for the delay once. */
+		template<class View>
+		void readBlock(const View &view, Sample delaySamples, Sample *output, int length) const {
+			auto storage = view.storage();
+			int startIndex = delaySamples;
+			Sample remainder = delaySamples - startIndex;
+			unsigned firstIndex = storage.index - unsigned(length - 1) - unsigned(startIndex);
+			readFixedBlock(static_cast<const Super &>(*this), storage.data, storage.mask, firstIndex, remainder, output, length, 0);
+		}
+	private:
+		template<class I>
+		static auto readFractionalBlock(const I &interpolator, const Sample *data, unsigned mask, const unsigned *indices, const Sample *fractions, Sample *output, int count, int) -> decltype(interpolator.fractionalBlock(data, mask, indices, fractions, output, count)) {
+			interpolator.fractionalBlock(data, mask, indices, fractions, output, count);
+		}
+		template<class I>
+		static void readFractionalBlock(const I &interpolator, const Sample *data, unsigned mask, const unsigned *indices, const Sample *fractions, Sample *output, int count, long) {
+			struct Masked {
+				const Sample *data;
+				unsigned index, mask;
+				Sample operator [](int i) const {
+					return data[(index - unsigned(i))&mask];
+				}
+			};
+			for (int i = 0; i < count; ++i) {
+				output[i] = interpolator.fractional(Masked{data, indices[i], mask}, fractions[i]);
+			}
+		}
+		template<class I>
+		static auto readFixedBlock(const I &interpolator, const Sample *data, unsigned mask, unsigned firstIndex, Sample fraction, Sample *output, int count, int) -> decltype(interpolator.fractionalFixedBlock(data, mask, firstIndex, fraction, output, count)) {
+			interpolator.fractionalFixedBlock(data, mask, firstIndex, fraction, output, count);
+		}
+		template<class I>
+		static void readFixedBlock(const I &interpolator, const Sample *data, unsigned mask, unsigned firstIndex, Sample fraction, Sample *output, int count, long) {
+			constexpr int maxCount = 64;
+			unsigned indices[maxCount];
+			Sample fractions[maxCount];
+			for (int start = 0; start < count; start += maxCount) {
+				int blockCount = std::min(count - start, maxCount);
+				for (int i = 0; i < blockCount; ++i) {
+					indices[i] = firstIndex + unsigned(start + i);
+					fractions[i] = fraction;
+				}
+				readFractionalBlock(interpolator, data, mask, indices, fractions, output + start, blockCount, 0);
+			}
+		}
 	};
 
 	/**	@brief A single-channel delay-line containing its own buffer.*/
@@ -625,6 +1165,10 @@ namespace delay {
 		void resize(int minCapacity, Sample value=Sample()) {
 			buffer.resize(minCapacity + Super::inputLength, value);
 		}
+		/// See `Buffer::setMirrored()`
+		bool setMirrored(bool mirrored, Sample value=Sample()) {
+			return buffer.setMirrored(mirrored, value);
+		}
 		
 		/** Read a sample from `delaySamples` >= 0 in the past.
 		The interpolator may add its own latency on top of this (see `Delay::latency`).  The default interpolation (linear) has 0 latency.
@@ -638,6 +1182,29 @@ namespace delay {
 			buffer[0] = value;
 			return *this;
 		}
+
+		/// Writes a block of samples, equivalent to calling `.write()` for each one
+		template<class Data>
+		Delay & writeBlock(const Data &data, int length) {
+			buffer += length;
+			buffer.view(1 - length).write(data, length);
+			return *this;
+		}
+		/** Reads a block with per-sample delays, for the last `length` samples written.
+		`output[i]` is what `.read(delays[i])` would have returned straight after writing sample `i`, so the capacity must cover the largest delay plus `length`. */
+		void readBlock(const Sample *delays, Sample *output, int length) const {
+			Super::readBlock(buffer.view(), delays, output, length);
+		}
+		/// Reads a block with the same delay for every sample (see `Reader::readBlock()`)
+		void readBlock(Sample delaySamples, Sample *output, int length) const {
+			Super::readBlock(buffer.view(), delaySamples, output, length);
+		}
+		/// Reads several taps (each with its own delays and output) with `.readBlock()`
+		void readBlock(const Sample * const *delays, Sample * const *outputs, int taps, int length) const {
+			for (int t = 0; t < taps; ++t) {
+				Super::readBlock(buffer.view(), delays[t], outputs[t], length);
+			}
+		}
 	};
 
 	/**	@brief A multi-channel delay-line with its own buffer. */
@@ -658,6 +1225,10 @@ namespace delay {
 			channels = nChannels;
 			multiBuffer.resize(channels, capacity + Super::inputLength, value);
 		}
+		/// See `Buffer::setMirrored()`
+		bool setMirrored(bool mirrored, Sample value=Sample()) {
+			return multiBuffer.setMirrored(mirrored, value);
+		}
 		
 		/// A single-channel delay-line view, similar to a `const Delay`
 		struct ChannelView {
@@ -669,6 +1240,13 @@ namespace delay {
 			Sample read(Sample delaySamples) const {
 				return reader.read(channel, delaySamples);
 			}
+			/// See `Delay::readBlock()`
+			void readBlock(const Sample *delays, Sample *output, int length) const {
+				reader.readBlock(channel, delays, output, length);
+			}
+			void readBlock(Sample delaySamples, Sample *output, int length) const {
+				reader.readBlock(channel, delaySamples, output, length);
+			}
 		};
 		ChannelView operator [](int channel) const {
 			return ChannelView{*this, multiBuffer[channel]};
@@ -710,6 +1288,132 @@ namespace delay {
 			}
 			return *this;
 		}
+		/// Writes a block of samples, for any type where `data[channel][index]` returns samples
+		template<class Data>
+		MultiDelay & writeBlock(const Data &data, int length) {
+			for (int c = 0; c < channels; ++c) {
+				(multiBuffer[c] + 1).write(data[c], length);
+			}
+			multiBuffer += length;
+			return *this;
+		}
+	};
+
+	/** @brief A multi-channel delay-line with interleaved channels (see `InterleavedBuffer`), for things like FDNs with many lines.
+
+		Reading every channel with the same delay (`.read()`) only works out the interpolation weights once, and then sums whole frames - so the inner loops run across the channels, on contiguous samples.  Interpolators can provide `.fractionalWeights()` for this, otherwise the weights are found by interpolating unit impulses (which relies on the interpolation being linear, as it is for all the interpolators here).
+		
+		Separate delays for each channel (`.readMulti()`) gather each channel's inputs with the frame stride.
+	*/
+	template<class Sample, template<typename> class Interpolator=InterpolatorLinear>
+	class InterleavedDelay : private Reader<Sample, Interpolator> {
+		using Super = Reader<Sample, Interpolator>;
+		InterleavedBuffer<Sample> buffer;
+		std::vector<Sample> frameSum;
+	public:
+		static constexpr Sample latency = Super::latency;
+
+		InterleavedDelay(int channels=0, int capacity=0) : buffer(channels, 1 + capacity + Super::inputLength), frameSum(channels) {}
+		/// Pass in a configured interpolator
+		InterleavedDelay(const Interpolator<Sample> &interp, int channels=0, int capacity=0) : Super(interp), buffer(channels, 1 + capacity + Super::inputLength), frameSum(channels) {}
+
+		void reset(Sample value=Sample()) {
+			buffer.reset(value);
+		}
+		void resize(int nChannels, int capacity, Sample value=Sample()) {
+			buffer.resize(nChannels, capacity + Super::inputLength, value);
+			frameSum.assign(nChannels, 0);
+		}
+		int channels() const {
+			return buffer.channels();
+		}
+
+		/// Reads every channel with the same delay, into the provided output structure
+		template<class Output>
+		void read(Sample delaySamples, Output &&output) {
+			int startIndex = delaySamples;
+			Sample remainder = delaySamples - startIndex;
+			Sample weights[Super::inputLength];
+			interpolationWeights(static_cast<const Interpolator<Sample> &>(*this), remainder, weights, 0);
+
+			const int channels = buffer.channels();
+			Sample *sum = frameSum.data();
+			const Sample *frame = buffer.frame(-startIndex);
+			for (int c = 0; c < channels; ++c) {
+				sum[c] = frame[c]*weights[0];
+			}
+			for (int i = 1; i < Super::inputLength; ++i) {
+				const Sample *olderFrame = buffer.frame(-startIndex - i);
+				Sample weight = weights[i];
+				for (int c = 0; c < channels; ++c) {
+					sum[c] += olderFrame[c]*weight;
+				}
+			}
+			for (int c = 0; c < channels; ++c) {
+				output[c] = sum[c];
+			}
+		}
+		/// Reads separate delays for each channel
+		template<class Delays, class Output>
+		void readMulti(const Delays &delays, Output &&output) const {
+			auto storage = buffer.storage();
+			for (int c = 0; c < storage.channels; ++c) {
+				Sample delaySamples = delays[c];
+				int startIndex = delaySamples;
+				Sample remainder = delaySamples - startIndex;
+				output[c] = Super::fractional(Gather{storage.data + c, storage.index - unsigned(startIndex), storage.mask, unsigned(storage.channels)}, remainder);
+			}
+		}
+
+		/// Writes a frame, for any type where `data[channel]` returns samples
+		template<class Data>
+		InterleavedDelay & write(const Data &data) {
+			++buffer;
+			Sample *frame = buffer.frame(0);
+			for (int c = 0, channels = buffer.channels(); c < channels; ++c) {
+				frame[c] = data[c];
+			}
+			return *this;
+		}
+		/// Writes a block of samples, for any type where `data[channel][index]` returns samples
+		template<class Data>
+		InterleavedDelay & writeBlock(const Data &data, int length) {
+			const int channels = buffer.channels();
+			for (int i = 0; i < length; ++i) {
+				Sample *frame = buffer.frame(i + 1);
+				for (int c = 0; c < channels; ++c) {
+					frame[c] = data[c][i];
+				}
+			}
+			buffer += length;
+			return *this;
+		}
+	private:
+		// One channel's inputs, with the newest (`index`) first
+		struct Gather {
+			const Sample *data;
+			unsigned index, mask, stride;
+			Sample operator [](int i) const {
+				return data[((index - unsigned(i))&mask)*stride];
+			}
+		};
+
+		template<class I>
+		static auto interpolationWeights(const I &interpolator, Sample fraction, Sample *weights, int) -> decltype(interpolator.fractionalWeights(fraction, weights)) {
+			interpolator.fractionalWeights(fraction, weights);
+		}
+		template<class I>
+		static void interpolationWeights(const I &interpolator, Sample fraction, Sample *weights, long) {
+			struct Impulse {
+				int position;
+				Sample operator [](int i) const {
+					return (i == position) ? 1 : 0;
+				}
+			};
+			for (int i = 0; i < Super::inputLength; ++i) {
+				weights[i] = interpolator.fractional(Impulse{i}, fraction);
+			}
+		}
 	};
 
 /** @} */
@@ -7,6 +7,7 @@
 #include <random>
 #include <vector>
 #include <iterator>
+#include <algorithm>
 
 namespace signalsmith {
 namespace envelopes {
@@ -177,6 +178,42 @@ namespace envelopes {
 			write(value);
 			return read(width);
 		}
+
+		/// Block version of `.readWrite()`, with the same results.  This can be in-place.
+		template<class InputData, class OutputData>
+		void readWrite(InputData &&input, OutputData &&output, int length, int width) {
+			Sample *bufferData = buffer.data();
+			int i = 0;
+			while (i < length) {
+				if (index + 1 == bufferLength) {
+					// The write index wraps around
+					output[i] = readWrite(input[i], width);
+					++i;
+					continue;
+				}
+				// Local copies, since `output` might alias the members
+				int end = i + std::min(length - i, bufferLength - 1 - index);
+				int j = index;
+				Sample s = sum;
+				// The read index is before the start of the buffer
+				int wrappedEnd = std::min(end, i + std::max(0, width - 1 - j));
+				for (; i < wrappedEnd; ++i) {
+					s += Sample(input[i]);
+					bufferData[++j] = s;
+					double result = s;
+					result += wrapJump;
+					output[i] = Sample(result - bufferData[j - width + bufferLength]);
+				}
+				for (; i < end; ++i) {
+					s += Sample(input[i]);
+					bufferData[++j] = s;
+					double result = s;
+					output[i] = Sample(result - bufferData[j - width]);
+				}
+				index = j;
+				sum = s;
+			}
+		}
 	};
 	
 	/** Rectangular moving average filter (FIR).
@@ -212,6 +249,15 @@ namespace envelopes {
 		Sample operator()(Sample v) {
 			return boxSum.readWrite(v, _length)*multiplier;
 		}
+
+		/// Processes a block, with the same results as calling `filter(v)` for each sample.  This can be in-place.
+		template<class InputData, class OutputData>
+		void process(InputData &&input, OutputData &&output, int length) {
+			boxSum.readWrite(input, output, length, _length);
+			for (int i = 0; i < length; ++i) {
+				output[i] = Sample(output[i])*multiplier;
+			}
+		}
 	};
 
 	/** FIR filter made from a stack of `BoxFilter`s.
@@ -353,6 +399,19 @@ namespace envelopes {
 			}
 			return v;
 		}
+
+		/// Processes a block one layer at a time, with the same results as calling `filter(v)` for each sample.  This can be in-place.
+		template<class InputData, class OutputData>
+		void process(InputData &&input, OutputData &&output, int length) {
+			if (layers.size() == 0) {
+				for (int i = 0; i < length; ++i) output[i] = Sample(input[i]);
+				return;
+			}
+			layers[0].filter.process(input, output, length);
+			for (size_t l = 1; l < layers.size(); ++l) {
+				layers[l].filter.process(output, output, length);
+			}
+		}
 	};
 	
 	/** Peak-hold filter.
@@ -484,6 +543,50 @@ namespace envelopes {
 			pop();
 			return read();
 		}
+
+		/// Processes a block, with the same results as calling `filter(v)` for each sample.  This can be in-place.
+		template<class InputData, class OutputData>
+		void process(InputData &&input, OutputData &&output, int length) {
+			Sample *bufferData = buffer.data();
+			int i = 0;
+			while (i < length) {
+				if (backIndex == middleStart) {
+					// The back is empty, so `.pop()` moves things along
+					output[i] = (*this)(input[i]);
+					++i;
+					continue;
+				}
+				// Local copies, since `output` might alias the members
+				int end = i + std::min(length - i, middleStart - backIndex);
+				int mask = bufferMask, front = frontIndex, back = backIndex, working = workingIndex;
+				Sample fMax = frontMax, wMax = workingMax, mMax = middleMax;
+				// Still filling in the working maximums
+				int workingEnd = std::min(end, i + (working - middleStart));
+				for (; i < workingEnd; ++i) {
+					Sample v = input[i];
+					bufferData[front&mask] = v;
+					++front;
+					fMax = std::max(fMax, v);
+					++back;
+					--working;
+					bufferData[working&mask] = wMax = std::max(wMax, bufferData[working&mask]);
+					output[i] = std::max(bufferData[back&mask], std::max(mMax, fMax));
+				}
+				for (; i < end; ++i) {
+					Sample v = input[i];
+					bufferData[front&mask] = v;
+					++front;
+					fMax = std::max(fMax, v);
+					++back;
+					output[i] = std::max(bufferData[back&mask], std::max(mMax, fMax));
+				}
+				frontIndex = front;
+				backIndex = back;
+				workingIndex = working;
+				frontMax = fMax;
+				workingMax = wMax;
+			}
+		}
 	};
 	
 	/** Peak-decay filter with a linear shape and fixed-time return to constant value.
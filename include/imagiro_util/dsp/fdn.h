@@ -0,0 +1,304 @@
+#include "./common.h"
+
+#ifndef SIGNALSMITH_DSP_FDN_H
+#define SIGNALSMITH_DSP_FDN_H
+
+#include "./delay.h"
+#include "./filters.h"
+#include "./mix.h"
+#include "./perf.h"
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+namespace signalsmith {
+namespace fdn {
+	/**	@defgroup FDN Feedback delay networks
+		@brief A block-based FDN engine, for reverbs
+
+		@{
+		@file
+	*/
+
+	namespace _fdn_impl {
+		/// Applies a mixing matrix to a block, where `rows[c][i]` is sample `i` of channel `c`.  This fallback mixes one sample at a time.
+		template<typename Sample, int channels, class Matrix>
+		struct BlockMix {
+			static void inPlace(const Matrix &matrix, Sample * const *rows, int length) {
+				std::array<Sample, channels> frame;
+				for (int i = 0; i < length; ++i) {
+					for (int c = 0; c < channels; ++c) frame[c] = rows[c][i];
+					matrix.inPlace(frame);
+					for (int c = 0; c < channels; ++c) rows[c][i] = frame[c];
+				}
+			}
+		};
+		/// Hadamard butterflies, run across the whole block so that the inner loops are contiguous
+		template<typename Sample, int channels>
+		struct BlockMix<Sample, channels, mix::Hadamard<Sample, channels>> {
+			static_assert((channels&(channels - 1)) == 0, "Hadamard size must be a power of 2");
+			static void inPlace(const mix::Hadamard<Sample, channels> &matrix, Sample * const *rows, int length) {
+				for (int hSize = channels/2; hSize > 0; hSize /= 2) {
+					for (int startIndex = 0; startIndex < channels; startIndex += hSize*2) {
+						for (int c = startIndex; c < startIndex + hSize; ++c) {
+							Sample *rowA = rows[c], *rowB = rows[c + hSize];
+							for (int i = 0; i < length; ++i) {
+								Sample a = rowA[i], b = rowB[i];
+								rowA[i] = a + b;
+								rowB[i] = a - b;
+							}
+						}
+					}
+				}
+				Sample factor = matrix.scalingFactor();
+				for (int c = 0; c < channels; ++c) {
+					Sample *row = rows[c];
+					for (int i = 0; i < length; ++i) row[i] *= factor;
+				}
+			}
+		};
+		/// Householder reflection, run across the whole block (using `sum` as scratch space)
+		template<typename Sample, int channels>
+		struct BlockMix<Sample, channels, mix::Householder<Sample, channels>> {
+			static void inPlace(const mix::Householder<Sample, channels> &, Sample * const *rows, int length, Sample *sum) {
+				const Sample factor = Sample(-2)/Sample(channels);
+				std::copy(rows[0], rows[0] + length, sum);
+				for (int c = 1; c < channels; ++c) {
+					const Sample *row = rows[c];
+					for (int i = 0; i < length; ++i) sum[i] += row[i];
+				}
+				for (int i = 0; i < length; ++i) sum[i] *= factor;
+				for (int c = 0; c < channels; ++c) {
+					Sample *row = rows[c];
+					for (int i = 0; i < length; ++i) row[i] += sum[i];
+				}
+			}
+		};
+
+		template<class Mix, class Matrix, typename Sample>
+		auto blockMix(const Matrix &matrix, Sample * const *rows, int length, Sample *scratch, int) -> decltype(Mix::inPlace(matrix, rows, length, scratch)) {
+			Mix::inPlace(matrix, rows, length, scratch);
+		}
+		template<class Mix, class Matrix, typename Sample>
+		void blockMix(const Matrix &matrix, Sample * const *rows, int length, Sample *, long) {
+			Mix::inPlace(matrix, rows, length);
+		}
+	}
+
+	/** @brief Feedback delay network with a fixed number of lines, processed in blocks
+
+		Each line has its own (optionally modulated) delay, a damping biquad and a feedback gain (from `.setDecay()`).  The line outputs are mixed with `Matrix` (`mix::Hadamard` or `mix::Householder`, or anything else with `.inPlace()`) and fed back, with stereo input/output spread across the lines by `mix::StereoMultiMixer`.
+
+		The feedback is computed a whole block at a time: each block is limited to the shortest delay (so every sample read was written in an earlier block), and the matrix/filter/mixing loops run along the block for each line, which lets them vectorise.  Delay reads use `delay::Reader::readBlock()`.
+
+		All memory is allocated in `.resize()`, and `.process()` doesn't allocate.
+	*/
+	template<typename Sample, int channels, class Matrix=mix::Hadamard<Sample, channels>, template<typename> class Interpolator=delay::InterpolatorLinear>
+	class FDN {
+		static_assert(channels > 0 && channels%2 == 0, "FDN needs an even (positive) number of lines");
+		using Reader = delay::Reader<Sample, Interpolator>;
+		using BlockMix = _fdn_impl::BlockMix<Sample, channels, Matrix>;
+
+		Matrix matrix;
+		Reader reader;
+		delay::MultiBuffer<Sample> buffer;
+		std::array<filters::BiquadStatic<Sample>, channels> dampingFilters;
+
+		// `depths` is `requestedDepths` limited to fit the current delays
+		std::array<Sample, channels> delays, requestedDepths, depths, gains;
+		std::array<std::complex<Sample>, channels> lfo, lfoStep;
+		Sample decaySamples = 48000;
+		int maxDelay = 0, maxBlock = 0, blockLimit = 1;
+
+		// Stereo spreading coefficients, taken from a `StereoMultiMixer`
+		std::array<Sample, channels> upLeft, upRight, downLeft, downRight;
+
+		int stride = 0; // between lines, in the scratch buffers below
+		signalsmith::perf::AlignedVector<Sample> lineScratch, delayScratch, mixScratch, outputScratch;
+
+		void updateLimits() {
+			for (int c = 0; c < channels; ++c) {
+				depths[c] = std::max(Sample(0), std::min({requestedDepths[c], delays[c] - 1, Sample(maxDelay) - delays[c]}));
+			}
+			Sample shortest = delays[0] - depths[0];
+			for (int c = 1; c < channels; ++c) {
+				shortest = std::min(shortest, delays[c] - depths[c]);
+			}
+			blockLimit = std::max(1, std::min(maxBlock, int(shortest)));
+			for (int c = 0; c < channels; ++c) {
+				gains[c] = std::pow(Sample(0.001), delays[c]/decaySamples);
+			}
+		}
+	public:
+		static constexpr Sample latency = Reader::latency;
+
+		FDN(int maxDelaySamples=0, int maxBlockLength=256) {
+			mix::StereoMultiMixer<Sample, channels> mixer;
+			std::array<Sample, 2> stereo;
+			std::array<Sample, channels> multi;
+			stereo = {1, 0};
+			mixer.stereoToMulti(stereo, upLeft);
+			stereo = {0, 1};
+			mixer.stereoToMulti(stereo, upRight);
+			for (int c = 0; c < channels; ++c) {
+				multi.fill(0);
+				multi[c] = 1;
+				mixer.multiToStereo(multi, stereo);
+				downLeft[c] = stereo[0];
+				downRight[c] = stereo[1];
+			}
+			// Scaled for independent lines, as they will be once the network has diffused
+			Sample scale = mixer.scalingFactor2();
+			for (int c = 0; c < channels; ++c) {
+				upLeft[c] *= scale;
+				upRight[c] *= scale;
+				downLeft[c] *= scale;
+				downRight[c] *= scale;
+			}
+
+			for (int c = 0; c < channels; ++c) {
+				delays[c] = 1;
+				requestedDepths[c] = depths[c] = 0;
+				lfo[c] = 1;
+				lfoStep[c] = 1;
+			}
+			resize(maxDelaySamples, maxBlockLength);
+		}
+
+		/// Allocates everything, and clears the lines.  The delays (including modulation) must stay below `maxDelaySamples`.
+		void resize(int maxDelaySamples, int maxBlockLength=256) {
+			maxDelay = std::max(maxDelaySamples, 1);
+			maxBlock = std::max(maxBlockLength, 1);
+			stride = (maxBlock + 15)/16*16;
+			buffer.resize(channels, maxDelay + maxBlock + Reader::inputLength + 1);
+			lineScratch.assign(channels*stride, 0);
+			delayScratch.assign(channels*stride, 0);
+			mixScratch.assign(stride, 0);
+			outputScratch.assign(2*stride, 0);
+			for (int c = 0; c < channels; ++c) {
+				delays[c] = std::min(delays[c], Sample(maxDelay));
+			}
+			updateLimits();
+			reset();
+		}
+		/// Clears the lines and the damping filter state
+		void reset() {
+			buffer.reset();
+			for (auto &filter : dampingFilters) filter.reset();
+		}
+
+		/// Sets the (unmodulated) delay for one line, in samples
+		void setDelay(int line, Sample delaySamples) {
+			delays[line] = std::max(Sample(1), std::min(delaySamples, Sample(maxDelay)));
+			updateLimits();
+		}
+		/// Sets every line's delay, for any type where `delaySamples[line]` returns samples
+		template<class Data>
+		void setDelays(const Data &delaySamples) {
+			for (int c = 0; c < channels; ++c) {
+				delays[c] = std::max(Sample(1), std::min(Sample(delaySamples[c]), Sample(maxDelay)));
+			}
+			updateLimits();
+		}
+		Sample delay(int line) const {
+			return delays[line];
+		}
+
+		/// Sinusoidal delay modulation for one line: `depthSamples` either side of the delay, with `scaledFreq` in cycles per sample
+		void setModulation(int line, Sample depthSamples, Sample scaledFreq) {
+			requestedDepths[line] = depthSamples;
+			Sample phase = scaledFreq*Sample(2*M_PI);
+			lfoStep[line] = {std::cos(phase), std::sin(phase)};
+			updateLimits();
+		}
+
+		/// Sets the feedback gains so that each line decays by 60dB over this many samples
+		void setDecay(Sample rt60Samples) {
+			decaySamples = std::max(rt60Samples, Sample(1e-6));
+			updateLimits();
+		}
+
+		/// The damping filter for one line, which can be configured directly (e.g. `.damping(0).highShelfDb(...)`)
+		filters::BiquadStatic<Sample> & damping(int line) {
+			return dampingFilters[line];
+		}
+
+		/// Processes stereo audio, for any types where `data[channel][index]` returns samples.  The (wet) output is replaced, not added to.
+		template<class In, class Out>
+		void process(In &&input, Out &&output, int length) {
+			Sample *lines[channels];
+			Sample *lineDelays[channels];
+			for (int c = 0; c < channels; ++c) {
+				lines[c] = lineScratch.data() + c*stride;
+				lineDelays[c] = delayScratch.data() + c*stride;
+			}
+
+			for (int done = 0; done < length;) {
+				int count = std::min(length - done, blockLimit);
+
+				// Read the line outputs, from before this block
+				for (int c = 0; c < channels; ++c) {
+					auto view = buffer[c] + count;
+					if (depths[c] > 0) {
+						Sample *lineDelay = lineDelays[c];
+						std::complex<Sample> phasor = lfo[c], step = lfoStep[c];
+						for (int i = 0; i < count; ++i) {
+							lineDelay[i] = delays[c] + depths[c]*phasor.imag();
+							phasor *= step;
+						}
+						// Keep the phasor's magnitude from drifting
+						lfo[c] = phasor*(Sample(1.5) - Sample(0.5)*std::norm(phasor));
+						reader.readBlock(view, lineDelay, lines[c], count);
+					} else {
+						reader.readBlock(view, delays[c], lines[c], count);
+					}
+				}
+
+				// The output is only written once the input's been used, so they can be the same buffers
+				Sample *wetLeft = outputScratch.data(), *wetRight = wetLeft + stride;
+				std::fill(wetLeft, wetLeft + count, Sample(0));
+				std::fill(wetRight, wetRight + count, Sample(0));
+				for (int c = 0; c < channels; ++c) {
+					const Sample *line = lines[c];
+					Sample toLeft = downLeft[c], toRight = downRight[c];
+					for (int i = 0; i < count; ++i) {
+						wetLeft[i] += line[i]*toLeft;
+						wetRight[i] += line[i]*toRight;
+					}
+				}
+
+				// Each filter is a serial recurrence, so we step through all the lines together, letting them overlap
+				for (int i = 0; i < count; ++i) {
+					for (int c = 0; c < channels; ++c) {
+						lines[c][i] = dampingFilters[c](lines[c][i])*gains[c];
+					}
+				}
+				_fdn_impl::blockMix<BlockMix>(matrix, lines, count, mixScratch.data(), 0);
+
+				auto &&inLeft = input[0];
+				auto &&inRight = input[1];
+				for (int c = 0; c < channels; ++c) {
+					Sample *line = lines[c];
+					Sample fromLeft = upLeft[c], fromRight = upRight[c];
+					for (int i = 0; i < count; ++i) {
+						line[i] += inLeft[done + i]*fromLeft + inRight[done + i]*fromRight;
+					}
+					(buffer[c] + 1).write(line, count);
+				}
+				buffer += count;
+
+				auto &&left = output[0];
+				auto &&right = output[1];
+				for (int i = 0; i < count; ++i) {
+					left[done + i] = wetLeft[i];
+					right[done + i] = wetRight[i];
+				}
+				done += count;
+			}
+		}
+	};
+
+/** @} */
+}} // signalsmith::fdn::
+#endif // include guard
@@ -8,6 +8,27 @@
 #include <vector>
 #include <complex>
 #include <cmath>
+#include <type_traits>
+#include <memory>
+#include <atomic>
+#include <mutex>
+
+// SIMD butterflies for contiguous float/double data.  Define `SIGNALSMITH_FFT_NO_SIMD` to only use the scalar path.
+#ifndef SIGNALSMITH_FFT_NO_SIMD
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define SIGNALSMITH_FFT_SSE2
+#		include <immintrin.h>
+#		if defined(__GNUC__) || defined(__clang__)
+#			define SIGNALSMITH_FFT_AVX2 __attribute__((target("avx2")))
+#		elif defined(_MSC_VER)
+#			include <intrin.h>
+#			define SIGNALSMITH_FFT_AVX2
+#		endif
+#	elif defined(__aarch64__) || defined(_M_ARM64)
+#		define SIGNALSMITH_FFT_NEON
+#		include <arm_neon.h>
+#	endif
+#endif
 
 namespace signalsmith { namespace fft {
 	/**	@defgroup FFT FFT (complex and real)
@@ -55,6 +76,73 @@ namespace signalsmith { namespace fft {
 			};
 		}
 
+		// Split-complex (separate real/imaginary arrays) equivalents of the above
+		template <bool conjugateSecond, typename V>
+		SIGNALSMITH_INLINE void splitMul(V aReal, V aImag, V bReal, V bImag, V &real, V &imag) {
+			if (conjugateSecond) {
+				real = bReal*aReal + bImag*aImag;
+				imag = bReal*aImag - bImag*aReal;
+			} else {
+				real = aReal*bReal - aImag*bImag;
+				imag = aReal*bImag + aImag*bReal;
+			}
+		}
+		template<bool inverse, typename V>
+		SIGNALSMITH_INLINE void splitStep2(V *real, V *imag, V twiddleReal, V twiddleImag, size_t stride) {
+			V aReal = real[0], aImag = imag[0], bReal, bImag;
+			splitMul<inverse>(real[stride], imag[stride], twiddleReal, twiddleImag, bReal, bImag);
+			real[0] = aReal + bReal;
+			imag[0] = aImag + bImag;
+			real[stride] = aReal - bReal;
+			imag[stride] = aImag - bImag;
+		}
+		// Twiddles for each factor `f` are at `twiddleReal[f*stride]`
+		template<bool inverse, typename V>
+		SIGNALSMITH_INLINE void splitStep4(V *real, V *imag, const V *twiddleReal, const V *twiddleImag, size_t stride) {
+			V aReal = real[0], aImag = imag[0], bReal, bImag, cReal, cImag, dReal, dImag;
+			splitMul<inverse>(real[stride], imag[stride], twiddleReal[stride*2], twiddleImag[stride*2], cReal, cImag);
+			splitMul<inverse>(real[stride*2], imag[stride*2], twiddleReal[stride], twiddleImag[stride], bReal, bImag);
+			splitMul<inverse>(real[stride*3], imag[stride*3], twiddleReal[stride*3], twiddleImag[stride*3], dReal, dImag);
+			V sumACReal = aReal + cReal, sumACImag = aImag + cImag;
+			V sumBDReal = bReal + dReal, sumBDImag = bImag + dImag;
+			V diffACReal = aReal - cReal, diffACImag = aImag - cImag;
+			V diffBDReal = bReal - dReal, diffBDImag = bImag - dImag;
+			real[0] = sumACReal + sumBDReal;
+			imag[0] = sumACImag + sumBDImag;
+			real[stride*2] = sumACReal - sumBDReal;
+			imag[stride*2] = sumACImag - sumBDImag;
+			real[stride] = inverse ? diffACReal - diffBDImag : diffACReal + diffBDImag;
+			imag[stride] = inverse ? diffACImag + diffBDReal : diffACImag - diffBDReal;
+			real[stride*3] = inverse ? diffACReal + diffBDImag : diffACReal - diffBDImag;
+			imag[stride*3] = inverse ? diffACImag - diffBDReal : diffACImag + diffBDReal;
+		}
+
+		// Reads complex values from separate real/imaginary arrays
+		template<typename V>
+		struct SplitIterator {
+			const V *real, *imag;
+
+			std::complex<V> operator[](size_t i) const {
+				return {real[i], imag[i]};
+			}
+			SplitIterator operator+(size_t i) const {
+				return {real + i, imag + i};
+			}
+		};
+
+		// Applies a complex rotation to each input value as it's read (offsetting moves the input, but not the rotations)
+		template<typename V>
+		struct RotatedIterator {
+			const std::complex<V> *input, *rotations;
+
+			std::complex<V> operator[](size_t i) const {
+				return complexMul<false>(input[i], rotations[i]);
+			}
+			RotatedIterator operator+(size_t i) const {
+				return {input + i, rotations};
+			}
+		};
+
 		// Use SFINAE to get an iterator from std::begin(), if supported - otherwise assume the value itself is an iterator
 		template<typename T, typename=void>
 		struct GetIterator {
@@ -68,12 +156,484 @@ namespace signalsmith { namespace fft {
 				return std::begin(t);
 			}
 		};
+
+		// Pointers and `std::vector` iterators (`const` ones only if `Value` is `const`)
+		template<typename Value, typename Iterator>
+		struct IsContiguous {
+			using Mutable = typename std::remove_const<Value>::type;
+			static constexpr bool value = std::is_same<Iterator, Mutable *>::value
+				|| std::is_same<Iterator, typename std::vector<Mutable>::iterator>::value
+				|| (std::is_const<Value>::value && (
+					std::is_same<Iterator, const Mutable *>::value
+					|| std::is_same<Iterator, typename std::vector<Mutable>::const_iterator>::value
+				));
+		};
+		// Gets a raw pointer from contiguous iterators (so we can use SIMD, or skip copies), or `nullptr` otherwise
+		template<typename Value, typename Iterator, typename=void>
+		struct ContiguousPointer {
+			static Value * get(const Iterator &) {
+				return nullptr;
+			}
+		};
+		template<typename Value, typename Iterator>
+		struct ContiguousPointer<Value, Iterator, typename std::enable_if<IsContiguous<Value, Iterator>::value>::type> {
+			static Value * get(const Iterator &iterator) {
+				return &*iterator;
+			}
+		};
+
+		/* SIMD packs hold `width` interleaved complex values (or `2*width` real values), and provide the primitives for the butterflies below.
+		The complex multiplication performs the same operations (in the same order) as `complexMul()`, so results match the scalar path. */
+#ifdef SIGNALSMITH_FFT_SSE2
+		struct PackSse2Float {
+			using Complex = std::complex<float>;
+			using V = __m128;
+			static constexpr size_t width = 2;
+			static SIGNALSMITH_INLINE V loadReals(const float *r) {return _mm_loadu_ps(r);}
+			static SIGNALSMITH_INLINE void storeReals(float *r, V v) {_mm_storeu_ps(r, v);}
+			static SIGNALSMITH_INLINE V load(const Complex *c) {return _mm_loadu_ps((const float *)c);}
+			static SIGNALSMITH_INLINE void store(Complex *c, V v) {_mm_storeu_ps((float *)c, v);}
+			static SIGNALSMITH_INLINE V gather(const Complex *c, size_t step) {
+				V low = _mm_castpd_ps(_mm_load_sd((const double *)c));
+				return _mm_loadh_pi(low, (const __m64 *)(c + step));
+			}
+			static SIGNALSMITH_INLINE V add(V a, V b) {return _mm_add_ps(a, b);}
+			static SIGNALSMITH_INLINE V sub(V a, V b) {return _mm_sub_ps(a, b);}
+			static SIGNALSMITH_INLINE V mul(V a, V b) {return _mm_mul_ps(a, b);}
+			static SIGNALSMITH_INLINE V dupReal(V a) {return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0));}
+			static SIGNALSMITH_INLINE V dupImag(V a) {return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1));}
+			static SIGNALSMITH_INLINE V swap(V a) {return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));}
+			static SIGNALSMITH_INLINE V negReal(V a) {return _mm_xor_ps(a, _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f));}
+			static SIGNALSMITH_INLINE V negImag(V a) {return _mm_xor_ps(a, _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f));}
+		};
+		struct PackSse2Double {
+			using Complex = std::complex<double>;
+			using V = __m128d;
+			static constexpr size_t width = 1;
+			static SIGNALSMITH_INLINE V loadReals(const double *r) {return _mm_loadu_pd(r);}
+			static SIGNALSMITH_INLINE void storeReals(double *r, V v) {_mm_storeu_pd(r, v);}
+			static SIGNALSMITH_INLINE V load(const Complex *c) {return _mm_loadu_pd((const double *)c);}
+			static SIGNALSMITH_INLINE void store(Complex *c, V v) {_mm_storeu_pd((double *)c, v);}
+			static SIGNALSMITH_INLINE V gather(const Complex *c, size_t) {return load(c);}
+			static SIGNALSMITH_INLINE V add(V a, V b) {return _mm_add_pd(a, b);}
+			static SIGNALSMITH_INLINE V sub(V a, V b) {return _mm_sub_pd(a, b);}
+			static SIGNALSMITH_INLINE V mul(V a, V b) {return _mm_mul_pd(a, b);}
+			static SIGNALSMITH_INLINE V dupReal(V a) {return _mm_unpacklo_pd(a, a);}
+			static SIGNALSMITH_INLINE V dupImag(V a) {return _mm_unpackhi_pd(a, a);}
+			static SIGNALSMITH_INLINE V swap(V a) {return _mm_shuffle_pd(a, a, 1);}
+			static SIGNALSMITH_INLINE V negReal(V a) {return _mm_xor_pd(a, _mm_setr_pd(-0.0, 0.0));}
+			static SIGNALSMITH_INLINE V negImag(V a) {return _mm_xor_pd(a, _mm_setr_pd(0.0, -0.0));}
+		};
+#	ifdef SIGNALSMITH_FFT_AVX2
+		struct PackAvx2Float {
+			using Complex = std::complex<float>;
+			using V = __m256;
+			static constexpr size_t width = 4;
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V loadReals(const float *r) {return _mm256_loadu_ps(r);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 void storeReals(float *r, V v) {_mm256_storeu_ps(r, v);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V load(const Complex *c) {return _mm256_loadu_ps((const float *)c);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 void store(Complex *c, V v) {_mm256_storeu_ps((float *)c, v);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V gather(const Complex *c, size_t step) {
+				__m128 low = _mm_loadh_pi(_mm_castpd_ps(_mm_load_sd((const double *)c)), (const __m64 *)(c + step));
+				__m128 high = _mm_loadh_pi(_mm_castpd_ps(_mm_load_sd((const double *)(c + 2*step))), (const __m64 *)(c + 3*step));
+				return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+			}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V add(V a, V b) {return _mm256_add_ps(a, b);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V sub(V a, V b) {return _mm256_sub_ps(a, b);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V mul(V a, V b) {return _mm256_mul_ps(a, b);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V dupReal(V a) {return _mm256_moveldup_ps(a);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V dupImag(V a) {return _mm256_movehdup_ps(a);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V swap(V a) {return _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V negReal(V a) {return _mm256_xor_ps(a, _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f));}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V negImag(V a) {return _mm256_xor_ps(a, _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f));}
+		};
+		struct PackAvx2Double {
+			using Complex = std::complex<double>;
+			using V = __m256d;
+			static constexpr size_t width = 2;
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V loadReals(const double *r) {return _mm256_loadu_pd(r);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 void storeReals(double *r, V v) {_mm256_storeu_pd(r, v);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V load(const Complex *c) {return _mm256_loadu_pd((const double *)c);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 void store(Complex *c, V v) {_mm256_storeu_pd((double *)c, v);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V gather(const Complex *c, size_t step) {
+				return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd((const double *)c)), _mm_loadu_pd((const double *)(c + step)), 1);
+			}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V add(V a, V b) {return _mm256_add_pd(a, b);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V sub(V a, V b) {return _mm256_sub_pd(a, b);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V mul(V a, V b) {return _mm256_mul_pd(a, b);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V dupReal(V a) {return _mm256_movedup_pd(a);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V dupImag(V a) {return _mm256_permute_pd(a, 0xF);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V swap(V a) {return _mm256_permute_pd(a, 0x5);}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V negReal(V a) {return _mm256_xor_pd(a, _mm256_setr_pd(-0.0, 0.0, -0.0, 0.0));}
+			static SIGNALSMITH_INLINE SIGNALSMITH_FFT_AVX2 V negImag(V a) {return _mm256_xor_pd(a, _mm256_setr_pd(0.0, -0.0, 0.0, -0.0));}
+		};
+
+		inline bool cpuSupportsAvx2() {
+#		if defined(__GNUC__) || defined(__clang__)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+#		else
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return false;
+			__cpuid(info, 1);
+			bool osxsave = info[2]&(1 << 27), avx = info[2]&(1 << 28);
+			if (!osxsave || !avx || (_xgetbv(0)&6) != 6) return false;
+			__cpuidex(info, 7, 0);
+			return info[1]&(1 << 5);
+#		endif
+		}
+#	endif
+#elif defined(SIGNALSMITH_FFT_NEON)
+		struct PackNeonFloat {
+			using Complex = std::complex<float>;
+			using V = float32x4_t;
+			static constexpr size_t width = 2;
+			static SIGNALSMITH_INLINE V loadReals(const float *r) {return vld1q_f32(r);}
+			static SIGNALSMITH_INLINE void storeReals(float *r, V v) {vst1q_f32(r, v);}
+			static SIGNALSMITH_INLINE V load(const Complex *c) {return vld1q_f32((const float *)c);}
+			static SIGNALSMITH_INLINE void store(Complex *c, V v) {vst1q_f32((float *)c, v);}
+			static SIGNALSMITH_INLINE V gather(const Complex *c, size_t step) {
+				return vcombine_f32(vld1_f32((const float *)c), vld1_f32((const float *)(c + step)));
+			}
+			static SIGNALSMITH_INLINE V add(V a, V b) {return vaddq_f32(a, b);}
+			static SIGNALSMITH_INLINE V sub(V a, V b) {return vsubq_f32(a, b);}
+			static SIGNALSMITH_INLINE V mul(V a, V b) {return vmulq_f32(a, b);}
+			static SIGNALSMITH_INLINE V dupReal(V a) {return vtrn1q_f32(a, a);}
+			static SIGNALSMITH_INLINE V dupImag(V a) {return vtrn2q_f32(a, a);}
+			static SIGNALSMITH_INLINE V swap(V a) {return vrev64q_f32(a);}
+			static SIGNALSMITH_INLINE V negReal(V a) {
+				const uint32_t mask[4] = {0x80000000u, 0, 0x80000000u, 0};
+				return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vld1q_u32(mask)));
+			}
+			static SIGNALSMITH_INLINE V negImag(V a) {
+				const uint32_t mask[4] = {0, 0x80000000u, 0, 0x80000000u};
+				return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vld1q_u32(mask)));
+			}
+		};
+		struct PackNeonDouble {
+			using Complex = std::complex<double>;
+			using V = float64x2_t;
+			static constexpr size_t width = 1;
+			static SIGNALSMITH_INLINE V loadReals(const double *r) {return vld1q_f64(r);}
+			static SIGNALSMITH_INLINE void storeReals(double *r, V v) {vst1q_f64(r, v);}
+			static SIGNALSMITH_INLINE V load(const Complex *c) {return vld1q_f64((const double *)c);}
+			static SIGNALSMITH_INLINE void store(Complex *c, V v) {vst1q_f64((double *)c, v);}
+			static SIGNALSMITH_INLINE V gather(const Complex *c, size_t) {return load(c);}
+			static SIGNALSMITH_INLINE V add(V a, V b) {return vaddq_f64(a, b);}
+			static SIGNALSMITH_INLINE V sub(V a, V b) {return vsubq_f64(a, b);}
+			static SIGNALSMITH_INLINE V mul(V a, V b) {return vmulq_f64(a, b);}
+			static SIGNALSMITH_INLINE V dupReal(V a) {return vdupq_laneq_f64(a, 0);}
+			static SIGNALSMITH_INLINE V dupImag(V a) {return vdupq_laneq_f64(a, 1);}
+			static SIGNALSMITH_INLINE V swap(V a) {return vextq_f64(a, a, 1);}
+			static SIGNALSMITH_INLINE V negReal(V a) {return vsetq_lane_f64(-vgetq_lane_f64(a, 0), a, 0);}
+			static SIGNALSMITH_INLINE V negImag(V a) {return vsetq_lane_f64(-vgetq_lane_f64(a, 1), a, 1);}
+		};
+#endif
+
+		/* Radix-2 and radix-4 butterflies, generic over the SIMD pack.
+		These are defined through a macro so that each instruction set gets its own copy with the matching `target` attribute (needed for runtime-dispatched AVX2). */
+#define SIGNALSMITH_FFT_SIMD_STEPS(TARGET) \
+		template<class Pack, bool conjugateSecond> \
+		SIGNALSMITH_INLINE TARGET typename Pack::V complexMul(typename Pack::V a, typename Pack::V b) { \
+			typename Pack::V cross = Pack::mul(Pack::swap(a), Pack::dupImag(b)); \
+			return Pack::add(Pack::mul(a, Pack::dupReal(b)), conjugateSecond ? Pack::negImag(cross) : Pack::negReal(cross)); \
+		} \
+		template<class Pack, bool flipped> \
+		SIGNALSMITH_INLINE TARGET typename Pack::V complexAddI(typename Pack::V a, typename Pack::V b) { \
+			return Pack::add(a, flipped ? Pack::negImag(Pack::swap(b)) : Pack::negReal(Pack::swap(b))); \
+		} \
+		template<class Pack, bool inverse> \
+		TARGET void fftStep2(typename Pack::Complex *origData, const typename Pack::Complex *twiddles, size_t stride, size_t outerRepeats) { \
+			using V = typename Pack::V; \
+			const size_t vectorEnd = stride - stride%Pack::width; \
+			for (size_t outerRepeat = 0; outerRepeat < outerRepeats; ++outerRepeat) { \
+				auto *data = origData + outerRepeat*2*stride; \
+				size_t i = 0; \
+				for (; i < vectorEnd; i += Pack::width) { \
+					V A = Pack::load(data + i); \
+					V B = complexMul<Pack, inverse>(Pack::load(data + i + stride), Pack::gather(twiddles + 2*i + 1, 2)); \
+					Pack::store(data + i, Pack::add(A, B)); \
+					Pack::store(data + i + stride, Pack::sub(A, B)); \
+				} \
+				for (; i < stride; ++i) { \
+					auto A = data[i]; \
+					auto B = ::signalsmith::fft::_fft_impl::complexMul<inverse>(data[i + stride], twiddles[2*i + 1]); \
+					data[i] = A + B; \
+					data[i + stride] = A - B; \
+				} \
+			} \
+		} \
+		template<class Pack, bool inverse> \
+		TARGET void fftStep4(typename Pack::Complex *origData, const typename Pack::Complex *twiddles, size_t stride, size_t outerRepeats) { \
+			using V = typename Pack::V; \
+			const size_t vectorEnd = stride - stride%Pack::width; \
+			for (size_t outerRepeat = 0; outerRepeat < outerRepeats; ++outerRepeat) { \
+				auto *data = origData + outerRepeat*4*stride; \
+				size_t i = 0; \
+				for (; i < vectorEnd; i += Pack::width) { \
+					const auto *tw = twiddles + 4*i; \
+					V A = Pack::load(data + i); \
+					V C = complexMul<Pack, inverse>(Pack::load(data + i + stride), Pack::gather(tw + 2, 4)); \
+					V B = complexMul<Pack, inverse>(Pack::load(data + i + stride*2), Pack::gather(tw + 1, 4)); \
+					V D = complexMul<Pack, inverse>(Pack::load(data + i + stride*3), Pack::gather(tw + 3, 4)); \
+					V sumAC = Pack::add(A, C), sumBD = Pack::add(B, D); \
+					V diffAC = Pack::sub(A, C), diffBD = Pack::sub(B, D); \
+					Pack::store(data + i, Pack::add(sumAC, sumBD)); \
+					Pack::store(data + i + stride, complexAddI<Pack, !inverse>(diffAC, diffBD)); \
+					Pack::store(data + i + stride*2, Pack::sub(sumAC, sumBD)); \
+					Pack::store(data + i + stride*3, complexAddI<Pack, inverse>(diffAC, diffBD)); \
+				} \
+				for (; i < stride; ++i) { \
+					const auto *tw = twiddles + 4*i; \
+					auto A = data[i]; \
+					auto C = ::signalsmith::fft::_fft_impl::complexMul<inverse>(data[i + stride], tw[2]); \
+					auto B = ::signalsmith::fft::_fft_impl::complexMul<inverse>(data[i + stride*2], tw[1]); \
+					auto D = ::signalsmith::fft::_fft_impl::complexMul<inverse>(data[i + stride*3], tw[3]); \
+					auto sumAC = A + C, sumBD = B + D; \
+					auto diffAC = A - C, diffBD = B - D; \
+					data[i] = sumAC + sumBD; \
+					data[i + stride] = ::signalsmith::fft::_fft_impl::complexAddI<!inverse>(diffAC, diffBD); \
+					data[i + stride*2] = sumAC - sumBD; \
+					data[i + stride*3] = ::signalsmith::fft::_fft_impl::complexAddI<inverse>(diffAC, diffBD); \
+				} \
+			} \
+		} \
+		template<class Pack, bool conjugateSecond> \
+		SIGNALSMITH_INLINE TARGET void splitMul(typename Pack::V aReal, typename Pack::V aImag, typename Pack::V bReal, typename Pack::V bImag, typename Pack::V &real, typename Pack::V &imag) { \
+			if (conjugateSecond) { \
+				real = Pack::add(Pack::mul(bReal, aReal), Pack::mul(bImag, aImag)); \
+				imag = Pack::sub(Pack::mul(bReal, aImag), Pack::mul(bImag, aReal)); \
+			} else { \
+				real = Pack::sub(Pack::mul(aReal, bReal), Pack::mul(aImag, bImag)); \
+				imag = Pack::add(Pack::mul(aReal, bImag), Pack::mul(aImag, bReal)); \
+			} \
+		} \
+		template<class Pack, bool inverse> \
+		TARGET void fftStep2Split(typename Pack::Complex::value_type *origReal, typename Pack::Complex::value_type *origImag, const typename Pack::Complex::value_type *twiddleReal, const typename Pack::Complex::value_type *twiddleImag, size_t stride, size_t outerRepeats) { \
+			using V = typename Pack::V; \
+			constexpr size_t realWidth = Pack::width*2; \
+			const size_t vectorEnd = stride - stride%realWidth; \
+			const auto *twReal = twiddleReal + stride, *twImag = twiddleImag + stride; \
+			for (size_t outerRepeat = 0; outerRepeat < outerRepeats; ++outerRepeat) { \
+				auto *real = origReal + outerRepeat*2*stride, *imag = origImag + outerRepeat*2*stride; \
+				size_t i = 0; \
+				for (; i < vectorEnd; i += realWidth) { \
+					V aReal = Pack::loadReals(real + i), aImag = Pack::loadReals(imag + i); \
+					V bReal, bImag; \
+					splitMul<Pack, inverse>(Pack::loadReals(real + i + stride), Pack::loadReals(imag + i + stride), Pack::loadReals(twReal + i), Pack::loadReals(twImag + i), bReal, bImag); \
+					Pack::storeReals(real + i, Pack::add(aReal, bReal)); \
+					Pack::storeReals(imag + i, Pack::add(aImag, bImag)); \
+					Pack::storeReals(real + i + stride, Pack::sub(aReal, bReal)); \
+					Pack::storeReals(imag + i + stride, Pack::sub(aImag, bImag)); \
+				} \
+				for (; i < stride; ++i) { \
+					::signalsmith::fft::_fft_impl::splitStep2<inverse>(real + i, imag + i, twReal[i], twImag[i], stride); \
+				} \
+			} \
+		} \
+		template<class Pack, bool inverse> \
+		TARGET void fftStep4Split(typename Pack::Complex::value_type *origReal, typename Pack::Complex::value_type *origImag, const typename Pack::Complex::value_type *twiddleReal, const typename Pack::Complex::value_type *twiddleImag, size_t stride, size_t outerRepeats) { \
+			using V = typename Pack::V; \
+			constexpr size_t realWidth = Pack::width*2; \
+			const size_t vectorEnd = stride - stride%realWidth; \
+			for (size_t outerRepeat = 0; outerRepeat < outerRepeats; ++outerRepeat) { \
+				auto *real = origReal + outerRepeat*4*stride, *imag = origImag + outerRepeat*4*stride; \
+				size_t i = 0; \
+				for (; i < vectorEnd; i += realWidth) { \
+					V aReal = Pack::loadReals(real + i), aImag = Pack::loadReals(imag + i); \
+					V bReal, bImag, cReal, cImag, dReal, dImag; \
+					splitMul<Pack, inverse>(Pack::loadReals(real + i + stride), Pack::loadReals(imag + i + stride), Pack::loadReals(twiddleReal + stride*2 + i), Pack::loadReals(twiddleImag + stride*2 + i), cReal, cImag); \
+					splitMul<Pack, inverse>(Pack::loadReals(real + i + stride*2), Pack::loadReals(imag + i + stride*2), Pack::loadReals(twiddleReal + stride + i), Pack::loadReals(twiddleImag + stride + i), bReal, bImag); \
+					splitMul<Pack, inverse>(Pack::loadReals(real + i + stride*3), Pack::loadReals(imag + i + stride*3), Pack::loadReals(twiddleReal + stride*3 + i), Pack::loadReals(twiddleImag + stride*3 + i), dReal, dImag); \
+					V sumACReal = Pack::add(aReal, cReal), sumACImag = Pack::add(aImag, cImag); \
+					V sumBDReal = Pack::add(bReal, dReal), sumBDImag = Pack::add(bImag, dImag); \
+					V diffACReal = Pack::sub(aReal, cReal), diffACImag = Pack::sub(aImag, cImag); \
+					V diffBDReal = Pack::sub(bReal, dReal), diffBDImag = Pack::sub(bImag, dImag); \
+					Pack::storeReals(real + i, Pack::add(sumACReal, sumBDReal)); \
+					Pack::storeReals(imag + i, Pack::add(sumACImag, sumBDImag)); \
+					Pack::storeReals(real + i + stride*2, Pack::sub(sumACReal, sumBDReal)); \
+					Pack::storeReals(imag + i + stride*2, Pack::sub(sumACImag, sumBDImag)); \
+					/* (diffAC +/- i*diffBD), matching complexAddI() */ \
+					Pack::storeReals(real + i + stride, inverse ? Pack::sub(diffACReal, diffBDImag) : Pack::add(diffACReal, diffBDImag)); \
+					Pack::storeReals(imag + i + stride, inverse ? Pack::add(diffACImag, diffBDReal) : Pack::sub(diffACImag, diffBDReal)); \
+					Pack::storeReals(real + i + stride*3, inverse ? Pack::add(diffACReal, diffBDImag) : Pack::sub(diffACReal, diffBDImag)); \
+					Pack::storeReals(imag + i + stride*3, inverse ? Pack::sub(diffACImag, diffBDReal) : Pack::add(diffACImag, diffBDReal)); \
+				} \
+				for (; i < stride; ++i) { \
+					::signalsmith::fft::_fft_impl::splitStep4<inverse>(real + i, imag + i, twiddleReal + i, twiddleImag + i, stride); \
+				} \
+			} \
+		}
+
+		namespace _simd_native {
+			SIGNALSMITH_FFT_SIMD_STEPS()
+		}
+#ifdef SIGNALSMITH_FFT_AVX2
+		namespace _simd_avx2 {
+			SIGNALSMITH_FFT_SIMD_STEPS(SIGNALSMITH_FFT_AVX2)
+		}
+#endif
+#undef SIGNALSMITH_FFT_SIMD_STEPS
+
+		/// Butterfly implementations for contiguous data, selected at runtime for the current CPU.  Unsupported types/platforms have null entries (so the scalar path is used).
+		template<typename V>
+		struct SimdSteps {
+			using Step = void (*)(std::complex<V> *data, const std::complex<V> *twiddles, size_t stride, size_t outerRepeats);
+			using SplitStep = void (*)(V *real, V *imag, const V *twiddleReal, const V *twiddleImag, size_t stride, size_t outerRepeats);
+			size_t width = 0;
+			Step step2[2] = {nullptr, nullptr}; // indexed by `inverse`
+			Step step4[2] = {nullptr, nullptr};
+			SplitStep step2Split[2] = {nullptr, nullptr};
+			SplitStep step4Split[2] = {nullptr, nullptr};
+
+			template<class Pack>
+			static SimdSteps native() {
+				SimdSteps result;
+				result.width = Pack::width;
+				result.step2[0] = _simd_native::fftStep2<Pack, false>;
+				result.step2[1] = _simd_native::fftStep2<Pack, true>;
+				result.step4[0] = _simd_native::fftStep4<Pack, false>;
+				result.step4[1] = _simd_native::fftStep4<Pack, true>;
+				result.step2Split[0] = _simd_native::fftStep2Split<Pack, false>;
+				result.step2Split[1] = _simd_native::fftStep2Split<Pack, true>;
+				result.step4Split[0] = _simd_native::fftStep4Split<Pack, false>;
+				result.step4Split[1] = _simd_native::fftStep4Split<Pack, true>;
+				return result;
+			}
+#ifdef SIGNALSMITH_FFT_AVX2
+			template<class Pack>
+			static SimdSteps avx2() {
+				SimdSteps result;
+				result.width = Pack::width;
+				result.step2[0] = _simd_avx2::fftStep2<Pack, false>;
+				result.step2[1] = _simd_avx2::fftStep2<Pack, true>;
+				result.step4[0] = _simd_avx2::fftStep4<Pack, false>;
+				result.step4[1] = _simd_avx2::fftStep4<Pack, true>;
+				result.step2Split[0] = _simd_avx2::fftStep2Split<Pack, false>;
+				result.step2Split[1] = _simd_avx2::fftStep2Split<Pack, true>;
+				result.step4Split[0] = _simd_avx2::fftStep4Split<Pack, false>;
+				result.step4Split[1] = _simd_avx2::fftStep4Split<Pack, true>;
+				return result;
+			}
+#endif
+		};
+		template<typename V>
+		SimdSteps<V> chooseSimdSteps(V*) {
+			return {};
+		}
+#ifdef SIGNALSMITH_FFT_SSE2
+		inline SimdSteps<float> chooseSimdSteps(float*) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (cpuSupportsAvx2()) return SimdSteps<float>::avx2<PackAvx2Float>();
+#	endif
+			return SimdSteps<float>::native<PackSse2Float>();
+		}
+		inline SimdSteps<double> chooseSimdSteps(double*) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (cpuSupportsAvx2()) return SimdSteps<double>::avx2<PackAvx2Double>();
+#	endif
+			return SimdSteps<double>::native<PackSse2Double>();
+		}
+#elif defined(SIGNALSMITH_FFT_NEON)
+		inline SimdSteps<float> chooseSimdSteps(float*) {
+			return SimdSteps<float>::native<PackNeonFloat>();
+		}
+		inline SimdSteps<double> chooseSimdSteps(double*) {
+			return SimdSteps<double>::native<PackNeonDouble>();
+		}
+#endif
+		/// The CPU check only happens once per type
+		template<typename V>
+		const SimdSteps<V> & simdSteps() {
+			static const SimdSteps<V> steps = chooseSimdSteps((V*)nullptr);
+			return steps;
+		}
+
+		/** Process-wide cache of immutable tables, constructed from a key (e.g. the size) and shared (reference-counted) between instances.
+		Lookups walk an atomic linked list without locking.  Missing entries are built and added under a mutex.  The cache only holds weak references, so tables are freed when the last instance using them goes away, and their (expired) entries are removed the next time something is added. */
+		template<class Tables, class Key=size_t>
+		class SharedTables {
+			struct Node {
+				Key key;
+				std::weak_ptr<const Tables> tables;
+				std::atomic<Node *> next;
+				Node(const Key &key, const std::shared_ptr<const Tables> &tables, Node *next) : key(key), tables(tables), next(next) {}
+			};
+			std::atomic<Node *> head{nullptr};
+			// Lookups currently walking the list.  Unlinked nodes are only deleted once this has been zero, so nobody can still be reading them.
+			std::atomic<int> activeLookups{0};
+			std::mutex addMutex;
+			std::vector<Node *> retired; // unlinked but not deleted yet
+
+			std::shared_ptr<const Tables> find(const Key &key) {
+				std::shared_ptr<const Tables> tables;
+				activeLookups.fetch_add(1);
+				for (Node *node = head.load(); node; node = node->next.load()) {
+					if (node->key == key) {
+						tables = node->tables.lock();
+						if (tables) break;
+					}
+				}
+				activeLookups.fetch_sub(1);
+				return tables;
+			}
+			// Unlinks expired entries, and deletes any (earlier) unlinked ones if nobody can still be reading them.  Called with the mutex held.
+			void prune() {
+				std::atomic<Node *> *link = &head;
+				while (Node *node = link->load(std::memory_order_relaxed)) {
+					if (node->tables.expired()) {
+						// Its `->next` is left alone, in case a lookup is currently on this node
+						link->store(node->next.load(std::memory_order_relaxed));
+						retired.push_back(node);
+					} else {
+						link = &node->next;
+					}
+				}
+				if (activeLookups.load() == 0) {
+					for (auto *node : retired) delete node;
+					retired.clear();
+				}
+			}
+			std::shared_ptr<const Tables> findOrAdd(const Key &key) {
+				std::shared_ptr<const Tables> tables = find(key);
+				if (tables) return tables;
+
+				std::lock_guard<std::mutex> lock(addMutex);
+				tables = find(key); // might have been added while we were waiting
+				if (tables) return tables;
+				prune();
+				// Not `std::make_shared()`, so the tables' memory is freed without waiting for the (weak) entry to be removed
+				tables = std::shared_ptr<const Tables>(new Tables(key));
+				head.store(new Node(key, tables, head.load(std::memory_order_relaxed)));
+				return tables;
+			}
+
+			SharedTables() {}
+			~SharedTables() {
+				for (Node *node = head.load(); node;) {
+					Node *next = node->next.load();
+					delete node;
+					node = next;
+				}
+				for (auto *node : retired) delete node;
+			}
+		public:
+			static std::shared_ptr<const Tables> get(const Key &key) {
+				static SharedTables cache;
+				return cache.findOrAdd(key);
+			}
+		};
 	}
 
 	/** Floating-point FFT implementation.
 	It is fast for 2^a * 3^b.
 	Here are the peak and RMS errors for `float`/`double` computation:
 	\diagram{fft-errors.svg Simulated errors for pure-tone harmonic inputs\, compared to a theoretical upper bound from "Roundoff error analysis of the fast Fourier transform" (G. Ramos, 1971)}
+
+	When the output is contiguous (a pointer or `std::vector` iterator) of `float`/`double`, the radix-2 and radix-4 steps use SIMD butterflies (SSE2/AVX2/NEON, with AVX2 chosen at runtime).  These give the same results as the scalar path.
+
+	The plan (factorisation, permutation and twiddles) is immutable, and shared between all instances of the same size and type, so constructing/resizing to a size which has been used before is cheap.
 	*/
 	template<typename V=double>
 	class FFT {
@@ -92,105 +652,123 @@ namespace signalsmith { namespace fft {
 			size_t outerRepeats;
 			size_t twiddleIndex;
 		};
-		std::vector<size_t> factors;
-		std::vector<Step> plan;
-		std::vector<complex> twiddleVector;
-		
-		struct PermutationPair {size_t from, to;};
-		std::vector<PermutationPair> permutation;
-		
-		void addPlanSteps(size_t factorIndex, size_t start, size_t length, size_t repeats) {
-			if (factorIndex >= factors.size()) return;
+		// Immutable tables for a given size, shared between all instances (see `_fft_impl::SharedTables`)
+		struct Plan {
+			std::vector<size_t> factors;
+			std::vector<Step> steps;
+			std::vector<complex> twiddleVector;
+			// The same twiddles, as separate real/imaginary arrays where each factor's twiddles are contiguous
+			std::vector<V> splitTwiddleReal, splitTwiddleImag;
+			
+			struct PermutationPair {size_t from, to;};
+			std::vector<PermutationPair> permutation;
+			
+			void addPlanSteps(size_t factorIndex, size_t start, size_t length, size_t repeats) {
+				if (factorIndex >= factors.size()) return;
 			
-			size_t factor = factors[factorIndex];
-			if (factorIndex + 1 < factors.size()) {
-				if (factors[factorIndex] == 2 && factors[factorIndex + 1] == 2) {
-					++factorIndex;
-					factor = 4;
+				size_t factor = factors[factorIndex];
+				if (factorIndex + 1 < factors.size()) {
+					if (factors[factorIndex] == 2 && factors[factorIndex + 1] == 2) {
+						++factorIndex;
+						factor = 4;
+					}
 				}
-			}
 
-			size_t subLength = length/factor;
-			Step mainStep{StepType::generic, factor, start, subLength, repeats, twiddleVector.size()};
+				size_t subLength = length/factor;
+				Step mainStep{StepType::generic, factor, start, subLength, repeats, twiddleVector.size()};
 
-			if (factor == 2) mainStep.type = StepType::step2;
-			if (factor == 3) mainStep.type = StepType::step3;
-			if (factor == 4) mainStep.type = StepType::step4;
+				if (factor == 2) mainStep.type = StepType::step2;
+				if (factor == 3) mainStep.type = StepType::step3;
+				if (factor == 4) mainStep.type = StepType::step4;
 
-			// Twiddles
-			bool foundStep = false;
-			for (const Step &existingStep : plan) {
-				if (existingStep.factor == mainStep.factor && existingStep.innerRepeats == mainStep.innerRepeats) {
-					foundStep = true;
-					mainStep.twiddleIndex = existingStep.twiddleIndex;
-					break;
+				// Twiddles
+				bool foundStep = false;
+				for (const Step &existingStep : steps) {
+					if (existingStep.factor == mainStep.factor && existingStep.innerRepeats == mainStep.innerRepeats) {
+						foundStep = true;
+						mainStep.twiddleIndex = existingStep.twiddleIndex;
+						break;
+					}
 				}
-			}
-			if (!foundStep) {
-				for (size_t i = 0; i < subLength; ++i) {
-					for (size_t f = 0; f < factor; ++f) {
-						double phase = 2*M_PI*i*f/length;
-						complex twiddle = {V(std::cos(phase)), V(-std::sin(phase))};
-						twiddleVector.push_back(twiddle);
+				if (!foundStep) {
+					for (size_t i = 0; i < subLength; ++i) {
+						for (size_t f = 0; f < factor; ++f) {
+							double phase = 2*M_PI*i*f/length;
+							complex twiddle = {V(std::cos(phase)), V(-std::sin(phase))};
+							twiddleVector.push_back(twiddle);
+						}
 					}
 				}
-			}
 
-			if (repeats == 1 && sizeof(complex)*subLength > 65536) {
-				for (size_t i = 0; i < factor; ++i) {
-					addPlanSteps(factorIndex + 1, start + i*subLength, subLength, 1);
-				}
-			} else {
-				addPlanSteps(factorIndex + 1, start, subLength, repeats*factor);
-			}
-			plan.push_back(mainStep);
-		}
-		void setPlan() {
-			factors.resize(0);
-			size_t size = _size, factor = 2;
-			while (size > 1) {
-				if (size%factor == 0) {
-					factors.push_back(factor);
-					size /= factor;
-				} else if (factor > sqrt(size)) {
-					factor = size;
+				if (repeats == 1 && sizeof(complex)*subLength > 65536) {
+					for (size_t i = 0; i < factor; ++i) {
+						addPlanSteps(factorIndex + 1, start + i*subLength, subLength, 1);
+					}
 				} else {
-					++factor;
+					addPlanSteps(factorIndex + 1, start, subLength, repeats*factor);
 				}
+				steps.push_back(mainStep);
 			}
+			Plan(size_t fftSize) {
+				size_t size = fftSize, factor = 2;
+				while (size > 1) {
+					if (size%factor == 0) {
+						factors.push_back(factor);
+						size /= factor;
+					} else if (factor > sqrt(size)) {
+						factor = size;
+					} else {
+						++factor;
+					}
+				}
 
-			plan.resize(0);
-			twiddleVector.resize(0);
-			addPlanSteps(0, 0, _size, 1);
-			
-			permutation.resize(0);
-			permutation.push_back(PermutationPair{0, 0});
-			size_t indexLow = 0, indexHigh = factors.size();
-			size_t inputStepLow = _size, outputStepLow = 1;
-			size_t inputStepHigh = 1, outputStepHigh = _size;
-			while (outputStepLow*inputStepHigh < _size) {
-				size_t f, inputStep, outputStep;
-				if (outputStepLow <= inputStepHigh) {
-					f = factors[indexLow++];
-					inputStep = (inputStepLow /= f);
-					outputStep = outputStepLow;
-					outputStepLow *= f;
-				} else {
-					f = factors[--indexHigh];
-					inputStep = inputStepHigh;
-					inputStepHigh *= f;
-					outputStep = (outputStepHigh /= f);
+				addPlanSteps(0, 0, fftSize, 1);
+
+				splitTwiddleReal.resize(twiddleVector.size());
+				splitTwiddleImag.resize(twiddleVector.size());
+				for (const Step &step : steps) {
+					for (size_t i = 0; i < step.innerRepeats; ++i) {
+						for (size_t f = 0; f < step.factor; ++f) {
+							complex twiddle = twiddleVector[step.twiddleIndex + i*step.factor + f];
+							splitTwiddleReal[step.twiddleIndex + f*step.innerRepeats + i] = twiddle.real();
+							splitTwiddleImag[step.twiddleIndex + f*step.innerRepeats + i] = twiddle.imag();
+						}
+					}
 				}
-				size_t oldSize = permutation.size();
-				for (size_t i = 1; i < f; ++i) {
-					for (size_t j = 0; j < oldSize; ++j) {
-						PermutationPair pair = permutation[j];
-						pair.from += i*inputStep;
-						pair.to += i*outputStep;
-						permutation.push_back(pair);
+			
+				permutation.push_back(PermutationPair{0, 0});
+				size_t indexLow = 0, indexHigh = factors.size();
+				size_t inputStepLow = fftSize, outputStepLow = 1;
+				size_t inputStepHigh = 1, outputStepHigh = fftSize;
+				while (outputStepLow*inputStepHigh < fftSize) {
+					size_t f, inputStep, outputStep;
+					if (outputStepLow <= inputStepHigh) {
+						f = factors[indexLow++];
+						inputStep = (inputStepLow /= f);
+						outputStep = outputStepLow;
+						outputStepLow *= f;
+					} else {
+						f = factors[--indexHigh];
+						inputStep = inputStepHigh;
+						inputStepHigh *= f;
+						outputStep = (outputStepHigh /= f);
+					}
+					size_t oldSize = permutation.size();
+					for (size_t i = 1; i < f; ++i) {
+						for (size_t j = 0; j < oldSize; ++j) {
+							PermutationPair pair = permutation[j];
+							pair.from += i*inputStep;
+							pair.to += i*outputStep;
+							permutation.push_back(pair);
+						}
 					}
 				}
 			}
+		};
+		std::shared_ptr<const Plan> sharedPlan;
+
+		void setPlan() {
+			sharedPlan = _fft_impl::SharedTables<Plan>::get(_size);
 		}
 
 		template<bool inverse, typename RandomAccessIterator>
@@ -201,7 +779,7 @@ namespace signalsmith { namespace fft {
 			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
 				RandomAccessIterator data = origData;
 				
-				const complex *twiddles = twiddleVector.data() + step.twiddleIndex;
+				const complex *twiddles = sharedPlan->twiddleVector.data() + step.twiddleIndex;
 				const size_t factor = step.factor;
 				for (size_t repeat = 0; repeat < step.innerRepeats; ++repeat) {
 					for (size_t i = 0; i < step.factor; ++i) {
@@ -226,7 +804,7 @@ namespace signalsmith { namespace fft {
 		template<bool inverse, typename RandomAccessIterator>
 		SIGNALSMITH_INLINE void fftStep2(RandomAccessIterator &&origData, const Step &step) {
 			const size_t stride = step.innerRepeats;
-			const complex *origTwiddles = twiddleVector.data() + step.twiddleIndex;
+			const complex *origTwiddles = sharedPlan->twiddleVector.data() + step.twiddleIndex;
 			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
 				const complex* twiddles = origTwiddles;
 				for (RandomAccessIterator data = origData; data < origData + stride; ++data) {
@@ -245,7 +823,7 @@ namespace signalsmith { namespace fft {
 		SIGNALSMITH_INLINE void fftStep3(RandomAccessIterator &&origData, const Step &step) {
 			constexpr complex factor3 = {-0.5, inverse ? 0.8660254037844386 : -0.8660254037844386};
 			const size_t stride = step.innerRepeats;
-			const complex *origTwiddles = twiddleVector.data() + step.twiddleIndex;
+			const complex *origTwiddles = sharedPlan->twiddleVector.data() + step.twiddleIndex;
 			
 			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
 				const complex* twiddles = origTwiddles;
@@ -270,7 +848,7 @@ namespace signalsmith { namespace fft {
 		template<bool inverse, typename RandomAccessIterator>
 		SIGNALSMITH_INLINE void fftStep4(RandomAccessIterator &&origData, const Step &step) {
 			const size_t stride = step.innerRepeats;
-			const complex *origTwiddles = twiddleVector.data() + step.twiddleIndex;
+			const complex *origTwiddles = sharedPlan->twiddleVector.data() + step.twiddleIndex;
 			
 			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
 				const complex* twiddles = origTwiddles;
@@ -296,28 +874,191 @@ namespace signalsmith { namespace fft {
 		
 		template<typename InputIterator, typename OutputIterator>
 		void permute(InputIterator input, OutputIterator data) {
-			for (auto pair : permutation) {
+			for (auto pair : sharedPlan->permutation) {
 				data[pair.from] = input[pair.to];
 			}
 		}
 
+		// `contiguousData` is either `nullptr`, or the same as `data` (so we can use the SIMD butterflies)
+		template<bool inverse, typename OutputIterator>
+		void runStep(const Step &step, OutputIterator &&data, complex *contiguousData, const _fft_impl::SimdSteps<V> &simd) {
+			bool useSimd = contiguousData && step.innerRepeats >= simd.width;
+			switch (step.type) {
+				case StepType::generic:
+					fftStepGeneric<inverse>(data + step.startIndex, step);
+					break;
+				case StepType::step2:
+					if (useSimd && simd.step2[inverse]) {
+						simd.step2[inverse](contiguousData + step.startIndex, sharedPlan->twiddleVector.data() + step.twiddleIndex, step.innerRepeats, step.outerRepeats);
+					} else {
+						fftStep2<inverse>(data + step.startIndex, step);
+					}
+					break;
+				case StepType::step3:
+					fftStep3<inverse>(data + step.startIndex, step);
+					break;
+				case StepType::step4:
+					if (useSimd && simd.step4[inverse]) {
+						simd.step4[inverse](contiguousData + step.startIndex, sharedPlan->twiddleVector.data() + step.twiddleIndex, step.innerRepeats, step.outerRepeats);
+					} else {
+						fftStep4<inverse>(data + step.startIndex, step);
+					}
+					break;
+			}
+		}
+
 		template<bool inverse, typename InputIterator, typename OutputIterator>
 		void run(InputIterator &&input, OutputIterator &&data) {
 			permute(input, data);
+
+			// Contiguous float/double data can use the SIMD butterflies
+			using Contiguous = _fft_impl::ContiguousPointer<complex, typename std::decay<OutputIterator>::type>;
+			complex *contiguousData = Contiguous::get(data);
+			const _fft_impl::SimdSteps<V> &simd = _fft_impl::simdSteps<V>();
 			
-			for (const Step &step : plan) {
+			for (const Step &step : sharedPlan->steps) {
+				runStep<inverse>(step, data, contiguousData, simd);
+			}
+		}
+
+		// Each step is run for every channel before moving onto the next, so the twiddles for that step stay in cache
+		template<bool inverse, typename InputIterator>
+		void runBatch(InputIterator input, complex *output, size_t channels, size_t inputStride, size_t outputStride) {
+			for (size_t c = 0; c < channels; ++c) {
+				permute(input + c*inputStride, output + c*outputStride);
+			}
+
+			const _fft_impl::SimdSteps<V> &simd = _fft_impl::simdSteps<V>();
+			for (const Step &step : sharedPlan->steps) {
+				for (size_t c = 0; c < channels; ++c) {
+					complex *data = output + c*outputStride;
+					runStep<inverse>(step, data, data, simd);
+				}
+			}
+		}
+
+		// Split-complex steps: the same as above, but with separate real/imaginary arrays
+		template<bool inverse>
+		void fftStepGenericSplit(V *origReal, V *origImag, const Step &step) {
+			complex *working = workingVector.data();
+			const size_t stride = step.innerRepeats, factor = step.factor;
+			const V *twiddleReal = sharedPlan->splitTwiddleReal.data() + step.twiddleIndex;
+			const V *twiddleImag = sharedPlan->splitTwiddleImag.data() + step.twiddleIndex;
+
+			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
+				V *real = origReal + outerRepeat*factor*stride, *imag = origImag + outerRepeat*factor*stride;
+				for (size_t repeat = 0; repeat < stride; ++repeat) {
+					for (size_t i = 0; i < factor; ++i) {
+						V wReal, wImag;
+						_fft_impl::splitMul<inverse>(real[i*stride + repeat], imag[i*stride + repeat], twiddleReal[i*stride + repeat], twiddleImag[i*stride + repeat], wReal, wImag);
+						working[i] = {wReal, wImag};
+					}
+					for (size_t f = 0; f < factor; ++f) {
+						complex sum = working[0];
+						for (size_t i = 1; i < factor; ++i) {
+							double phase = 2*M_PI*f*i/factor;
+							complex twiddle = {V(std::cos(phase)), V(-std::sin(phase))};
+							sum += _fft_impl::complexMul<inverse>(working[i], twiddle);
+						}
+						real[f*stride + repeat] = sum.real();
+						imag[f*stride + repeat] = sum.imag();
+					}
+				}
+			}
+		}
+
+		template<bool inverse>
+		void fftStep2Split(V *origReal, V *origImag, const Step &step) {
+			const size_t stride = step.innerRepeats;
+			const V *twiddleReal = sharedPlan->splitTwiddleReal.data() + step.twiddleIndex + stride;
+			const V *twiddleImag = sharedPlan->splitTwiddleImag.data() + step.twiddleIndex + stride;
+			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
+				V *real = origReal + outerRepeat*2*stride, *imag = origImag + outerRepeat*2*stride;
+				for (size_t i = 0; i < stride; ++i) {
+					_fft_impl::splitStep2<inverse>(real + i, imag + i, twiddleReal[i], twiddleImag[i], stride);
+				}
+			}
+		}
+
+		template<bool inverse>
+		void fftStep3Split(V *origReal, V *origImag, const Step &step) {
+			constexpr V factor3Real = -0.5, factor3Imag = inverse ? 0.8660254037844386 : -0.8660254037844386;
+			const size_t stride = step.innerRepeats;
+			const V *twiddleReal = sharedPlan->splitTwiddleReal.data() + step.twiddleIndex;
+			const V *twiddleImag = sharedPlan->splitTwiddleImag.data() + step.twiddleIndex;
+
+			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
+				V *real = origReal + outerRepeat*3*stride, *imag = origImag + outerRepeat*3*stride;
+				for (size_t i = 0; i < stride; ++i) {
+					V aReal = real[i], aImag = imag[i], bReal, bImag, cReal, cImag;
+					_fft_impl::splitMul<inverse>(real[i + stride], imag[i + stride], twiddleReal[stride + i], twiddleImag[stride + i], bReal, bImag);
+					_fft_impl::splitMul<inverse>(real[i + stride*2], imag[i + stride*2], twiddleReal[stride*2 + i], twiddleImag[stride*2 + i], cReal, cImag);
+
+					V realSumReal = aReal + (bReal + cReal)*factor3Real, realSumImag = aImag + (bImag + cImag)*factor3Real;
+					V imagSumReal = (bReal - cReal)*factor3Imag, imagSumImag = (bImag - cImag)*factor3Imag;
+
+					real[i] = aReal + bReal + cReal;
+					imag[i] = aImag + bImag + cImag;
+					real[i + stride] = realSumReal - imagSumImag;
+					imag[i + stride] = realSumImag + imagSumReal;
+					real[i + stride*2] = realSumReal + imagSumImag;
+					imag[i + stride*2] = realSumImag - imagSumReal;
+				}
+			}
+		}
+
+		template<bool inverse>
+		void fftStep4Split(V *origReal, V *origImag, const Step &step) {
+			const size_t stride = step.innerRepeats;
+			const V *twiddleReal = sharedPlan->splitTwiddleReal.data() + step.twiddleIndex;
+			const V *twiddleImag = sharedPlan->splitTwiddleImag.data() + step.twiddleIndex;
+			for (size_t outerRepeat = 0; outerRepeat < step.outerRepeats; ++outerRepeat) {
+				V *real = origReal + outerRepeat*4*stride, *imag = origImag + outerRepeat*4*stride;
+				for (size_t i = 0; i < stride; ++i) {
+					_fft_impl::splitStep4<inverse>(real + i, imag + i, twiddleReal + i, twiddleImag + i, stride);
+				}
+			}
+		}
+
+		template<typename InputIterator>
+		void permuteSplit(InputIterator input, V *real, V *imag) {
+			for (auto pair : sharedPlan->permutation) {
+				complex v = input[pair.to];
+				real[pair.from] = v.real();
+				imag[pair.from] = v.imag();
+			}
+		}
+
+		template<bool inverse, typename InputIterator>
+		void runSplit(InputIterator &&input, V *real, V *imag) {
+			permuteSplit(input, real, imag);
+
+			const _fft_impl::SimdSteps<V> &simd = _fft_impl::simdSteps<V>();
+			for (const Step &step : sharedPlan->steps) {
+				bool useSimd = step.innerRepeats >= simd.width*2;
+				V *stepReal = real + step.startIndex, *stepImag = imag + step.startIndex;
+				const V *twiddleReal = sharedPlan->splitTwiddleReal.data() + step.twiddleIndex;
+				const V *twiddleImag = sharedPlan->splitTwiddleImag.data() + step.twiddleIndex;
 				switch (step.type) {
 					case StepType::generic:
-						fftStepGeneric<inverse>(data + step.startIndex, step);
+						fftStepGenericSplit<inverse>(stepReal, stepImag, step);
 						break;
 					case StepType::step2:
-						fftStep2<inverse>(data + step.startIndex, step);
+						if (useSimd && simd.step2Split[inverse]) {
+							simd.step2Split[inverse](stepReal, stepImag, twiddleReal, twiddleImag, step.innerRepeats, step.outerRepeats);
+						} else {
+							fftStep2Split<inverse>(stepReal, stepImag, step);
+						}
 						break;
 					case StepType::step3:
-						fftStep3<inverse>(data + step.startIndex, step);
+						fftStep3Split<inverse>(stepReal, stepImag, step);
 						break;
 					case StepType::step4:
-						fftStep4<inverse>(data + step.startIndex, step);
+						if (useSimd && simd.step4Split[inverse]) {
+							simd.step4Split[inverse](stepReal, stepImag, twiddleReal, twiddleImag, step.innerRepeats, step.outerRepeats);
+						} else {
+							fftStep4Split<inverse>(stepReal, stepImag, step);
+						}
 						break;
 				}
 			}
@@ -393,6 +1134,52 @@ namespace signalsmith { namespace fft {
 			auto outputIter = _fft_impl::GetIterator<OutputIterator>::get(output);
 			return run<true>(inputIter, outputIter);
 		}
+
+		/** @name Batched (multi-channel)
+		Runs the same transform on several channels, sharing the plan: each step is completed for all channels before the next one starts.  Channel `c` is read from `input + c*inputStride` (which can be any iterator supporting `+`) and written to `output + c*outputStride`.  Channels must not overlap.
+		@{ */
+		template<typename InputIterator>
+		void fftBatch(InputIterator &&input, complex *output, size_t channels, size_t inputStride, size_t outputStride) {
+			auto inputIter = _fft_impl::GetIterator<InputIterator>::get(input);
+			return runBatch<false>(inputIter, output, channels, inputStride, outputStride);
+		}
+		template<typename InputIterator>
+		void fftBatch(InputIterator &&input, complex *output, size_t channels, size_t stride) {
+			return fftBatch(input, output, channels, stride, stride);
+		}
+		template<typename InputIterator>
+		void ifftBatch(InputIterator &&input, complex *output, size_t channels, size_t inputStride, size_t outputStride) {
+			auto inputIter = _fft_impl::GetIterator<InputIterator>::get(input);
+			return runBatch<true>(inputIter, output, channels, inputStride, outputStride);
+		}
+		template<typename InputIterator>
+		void ifftBatch(InputIterator &&input, complex *output, size_t channels, size_t stride) {
+			return ifftBatch(input, output, channels, stride, stride);
+		}
+		/// @}
+
+		/// @name Split-complex (separate real/imaginary arrays)
+		/// @{
+		/// FFT from any complex-valued input into split output arrays
+		template<typename InputIterator>
+		void fft(InputIterator &&input, V *outputReal, V *outputImag) {
+			auto inputIter = _fft_impl::GetIterator<InputIterator>::get(input);
+			return runSplit<false>(inputIter, outputReal, outputImag);
+		}
+		/// FFT with split input and output arrays
+		void fft(const V *inputReal, const V *inputImag, V *outputReal, V *outputImag) {
+			return runSplit<false>(_fft_impl::SplitIterator<V>{inputReal, inputImag}, outputReal, outputImag);
+		}
+
+		template<typename InputIterator>
+		void ifft(InputIterator &&input, V *outputReal, V *outputImag) {
+			auto inputIter = _fft_impl::GetIterator<InputIterator>::get(input);
+			return runSplit<true>(inputIter, outputReal, outputImag);
+		}
+		void ifft(const V *inputReal, const V *inputImag, V *outputReal, V *outputImag) {
+			return runSplit<true>(_fft_impl::SplitIterator<V>{inputReal, inputImag}, outputReal, outputImag);
+		}
+		/// @}
 	};
 
 	struct FFTOptions {
@@ -405,9 +1192,100 @@ namespace signalsmith { namespace fft {
 
 		using complex = std::complex<V>;
 		std::vector<complex> complexBuffer1, complexBuffer2;
-		std::vector<complex> twiddlesMinusI;
-		std::vector<complex> modifiedRotations;
+		std::vector<complex> batchBuffer;
+		// Immutable tables for a given size, shared between all instances (see `_fft_impl::SharedTables`)
+		struct Tables {
+			std::vector<complex> twiddlesMinusI;
+			std::vector<complex> modifiedRotations;
+
+			Tables(size_t size) {
+				size_t hhSize = size/4 + 1;
+				twiddlesMinusI.resize(hhSize);
+				for (size_t i = 0; i < hhSize; ++i) {
+					V rotPhase = -2*M_PI*(modified ? i + 0.5 : i)/size;
+					twiddlesMinusI[i] = {std::sin(rotPhase), -std::cos(rotPhase)};
+				}
+				if (modified) {
+					modifiedRotations.resize(size/2);
+					for (size_t i = 0; i < size/2; ++i) {
+						V rotPhase = -2*M_PI*i/size;
+						modifiedRotations[i] = {std::cos(rotPhase), std::sin(rotPhase)};
+					}
+				}
+			}
+		};
+		std::shared_ptr<const Tables> tables;
 		FFT<V> complexFft;
+
+		// Converts between bins `i`/`conjI` of the half-size complex FFT and the real FFT (safe to use in-place)
+		SIGNALSMITH_INLINE void unpackPair(size_t i, complex bin, complex conjBin, complex &result, complex &conjResult) const {
+			complex odd = (bin + conj(conjBin))*(V)0.5;
+			complex evenI = (bin - conj(conjBin))*(V)0.5;
+			complex evenRotMinusI = _fft_impl::complexMul<false>(evenI, tables->twiddlesMinusI[i]);
+
+			result = odd + evenRotMinusI;
+			conjResult = conj(odd - evenRotMinusI);
+		}
+		SIGNALSMITH_INLINE void packPair(size_t i, complex v, complex v2, complex &result, complex &conjResult) const {
+			complex odd = v + conj(v2);
+			complex evenRotMinusI = v - conj(v2);
+			complex evenI = _fft_impl::complexMul<true>(evenRotMinusI, tables->twiddlesMinusI[i]);
+			
+			result = odd + evenI;
+			conjResult = conj(odd - evenI);
+		}
+
+		// Reads pairs of real samples directly as complex input, and unpacks the result in-place
+		void fftContiguous(const V *input, complex *output) {
+			const complex *pairs = (const complex *)input;
+			if (modified) {
+				complexFft.fft(_fft_impl::RotatedIterator<V>{pairs, tables->modifiedRotations.data()}, output);
+			} else {
+				complexFft.fft(pairs, output);
+			}
+			unpackInPlace(output);
+		}
+		void unpackInPlace(complex *output) {
+			size_t hSize = complexFft.size();
+			if (!modified) output[0] = {
+				output[0].real() + output[0].imag(),
+				output[0].real() - output[0].imag()
+			};
+			for (size_t i = modified ? 0 : 1; i <= hSize/2; ++i) {
+				size_t conjI = modified ? (hSize  - 1 - i) : (hSize - i);
+				// The middle pair comes up twice (for even `hSize`), but it's already been overwritten by then - so only use the last one
+				if (modified && conjI == i + 1) continue;
+				complex result, conjResult;
+				unpackPair(i, output[i], output[conjI], result, conjResult);
+				output[i] = result;
+				output[conjI] = conjResult;
+			}
+		}
+		// Runs the half-size inverse FFT from `complexBuffer1`, directly into pairs of real output samples
+		void ifftPairs(complex *pairs) {
+			complexFft.ifft(complexBuffer1.data(), pairs);
+			rotateOutput(pairs);
+		}
+		void rotateOutput(complex *pairs) {
+			if (modified) {
+				size_t hSize = complexFft.size();
+				for (size_t i = 0; i < hSize; ++i) {
+					pairs[i] = _fft_impl::complexMul<true>(pairs[i], tables->modifiedRotations[i]);
+				}
+			}
+		}
+		template<typename InputIterator>
+		void packInto(InputIterator &&input, complex *packed) {
+			size_t hSize = complexFft.size();
+			if (!modified) packed[0] = {
+				input[0].real() + input[0].imag(),
+				input[0].real() - input[0].imag()
+			};
+			for (size_t i = modified ? 0 : 1; i <= hSize/2; ++i) {
+				size_t conjI = modified ? (hSize  - 1 - i) : (hSize - i);
+				packPair(i, input[i], input[conjI], packed[i], packed[conjI]);
+			}
+		}
 	public:
 		static size_t fastSizeAbove(size_t size) {
 			return FFT<V>::fastSizeAbove((size + 1)/2)*2;
@@ -425,20 +1303,7 @@ namespace signalsmith { namespace fft {
 		size_t setSize(size_t size) {
 			complexBuffer1.resize(size/2);
 			complexBuffer2.resize(size/2);
-
-			size_t hhSize = size/4 + 1;
-			twiddlesMinusI.resize(hhSize);
-			for (size_t i = 0; i < hhSize; ++i) {
-				V rotPhase = -2*M_PI*(modified ? i + 0.5 : i)/size;
-				twiddlesMinusI[i] = {std::sin(rotPhase), -std::cos(rotPhase)};
-			}
-			if (modified) {
-				modifiedRotations.resize(size/2);
-				for (size_t i = 0; i < size/2; ++i) {
-					V rotPhase = -2*M_PI*i/size;
-					modifiedRotations[i] = {std::cos(rotPhase), std::sin(rotPhase)};
-				}
-			}
+			tables = _fft_impl::SharedTables<Tables>::get(size);
 			
 			return complexFft.setSize(size/2);
 		}
@@ -452,12 +1317,25 @@ namespace signalsmith { namespace fft {
 			return complexFft.size()*2;
 		}
 
+		/** Real FFT, producing `size()/2` bins.
+		If the input and output are both contiguous (pointers or `std::vector`s) and don't overlap, the half-size FFT reads the input directly and the result is unpacked in-place in the output, with no intermediate copies. */
 		template<typename InputIterator, typename OutputIterator>
 		void fft(InputIterator &&input, OutputIterator &&output) {
 			size_t hSize = complexFft.size();
+
+			auto inputIter = _fft_impl::GetIterator<InputIterator>::get(input);
+			auto outputIter = _fft_impl::GetIterator<OutputIterator>::get(output);
+			const V *inputPointer = _fft_impl::ContiguousPointer<const V, decltype(inputIter)>::get(inputIter);
+			complex *outputPointer = _fft_impl::ContiguousPointer<complex, decltype(outputIter)>::get(outputIter);
+			if (inputPointer && outputPointer) {
+				const void *inputEnd = inputPointer + 2*hSize, *outputEnd = outputPointer + hSize;
+				bool overlapping = (const void *)outputPointer < inputEnd && (const void *)inputPointer < outputEnd;
+				if (!overlapping) return fftContiguous(inputPointer, outputPointer);
+			}
+
 			for (size_t i = 0; i < hSize; ++i) {
 				if (modified) {
-					complexBuffer1[i] = _fft_impl::complexMul<false>({input[2*i], input[2*i + 1]}, modifiedRotations[i]);
+					complexBuffer1[i] = _fft_impl::complexMul<false>({input[2*i], input[2*i + 1]}, tables->modifiedRotations[i]);
 				} else {
 					complexBuffer1[i] = {input[2*i], input[2*i + 1]};
 				}
@@ -471,44 +1349,122 @@ namespace signalsmith { namespace fft {
 			};
 			for (size_t i = modified ? 0 : 1; i <= hSize/2; ++i) {
 				size_t conjI = modified ? (hSize  - 1 - i) : (hSize - i);
-				
-				complex odd = (complexBuffer2[i] + conj(complexBuffer2[conjI]))*(V)0.5;
-				complex evenI = (complexBuffer2[i] - conj(complexBuffer2[conjI]))*(V)0.5;
-				complex evenRotMinusI = _fft_impl::complexMul<false>(evenI, twiddlesMinusI[i]);
-
-				output[i] = odd + evenRotMinusI;
-				output[conjI] = conj(odd - evenRotMinusI);
+				complex result, conjResult;
+				unpackPair(i, complexBuffer2[i], complexBuffer2[conjI], result, conjResult);
+				output[i] = result;
+				output[conjI] = conjResult;
 			}
 		}
 
+		/** Inverse real FFT, from `size()/2` bins.
+		If the output is contiguous, the half-size FFT writes into it directly (as pairs of real samples). */
 		template<typename InputIterator, typename OutputIterator>
 		void ifft(InputIterator &&input, OutputIterator &&output) {
 			size_t hSize = complexFft.size();
-			if (!modified) complexBuffer1[0] = {
-				input[0].real() + input[0].imag(),
-				input[0].real() - input[0].imag()
-			};
-			for (size_t i = modified ? 0 : 1; i <= hSize/2; ++i) {
-				size_t conjI = modified ? (hSize  - 1 - i) : (hSize - i);
-				complex v = input[i], v2 = input[conjI];
+			packInto(input, complexBuffer1.data());
 
-				complex odd = v + conj(v2);
-				complex evenRotMinusI = v - conj(v2);
-				complex evenI = _fft_impl::complexMul<true>(evenRotMinusI, twiddlesMinusI[i]);
-				
-				complexBuffer1[i] = odd + evenI;
-				complexBuffer1[conjI] = conj(odd - evenI);
-			}
+			// The input has been fully read, so it doesn't matter if the output overlaps it
+			auto outputIter = _fft_impl::GetIterator<OutputIterator>::get(output);
+			V *outputPointer = _fft_impl::ContiguousPointer<V, decltype(outputIter)>::get(outputIter);
+			if (outputPointer) return ifftPairs((complex *)outputPointer);
 			
 			complexFft.ifft(complexBuffer1.data(), complexBuffer2.data());
 			
 			for (size_t i = 0; i < hSize; ++i) {
 				complex v = complexBuffer2[i];
-				if (modified) v = _fft_impl::complexMul<true>(v, modifiedRotations[i]);
+				if (modified) v = _fft_impl::complexMul<true>(v, tables->modifiedRotations[i]);
 				output[2*i] = v.real();
 				output[2*i + 1] = v.imag();
 			}
 		}
+
+		/** @name Batched (multi-channel)
+		Runs the same transform on several channels, sharing the plan of the half-size complex FFT.  Real channel `c` starts at `input + c*inputStride` (or `output`), and its `size()/2` bins at `output + c*outputStride` (or `input`).
+		@{ */
+		/// Allocates the working space for inverse batches of up to `channels`, so `.ifftBatch()` doesn't allocate
+		void reserveBatch(size_t channels) {
+			size_t batchSize = channels*complexFft.size();
+			if (batchBuffer.size() < batchSize) batchBuffer.resize(batchSize);
+		}
+		/// The channels must not overlap each other, or the output
+		void fftBatch(const V *input, complex *output, size_t channels, size_t inputStride, size_t outputStride) {
+			// Channels are read as pairs of real samples, so each one has to start on a pair
+			if (inputStride%2) {
+				for (size_t c = 0; c < channels; ++c) {
+					fft(input + c*inputStride, output + c*outputStride);
+				}
+				return;
+			}
+
+			const complex *pairs = (const complex *)input;
+			if (modified) {
+				complexFft.fftBatch(_fft_impl::RotatedIterator<V>{pairs, tables->modifiedRotations.data()}, output, channels, inputStride/2, outputStride);
+			} else {
+				complexFft.fftBatch(pairs, output, channels, inputStride/2, outputStride);
+			}
+			for (size_t c = 0; c < channels; ++c) {
+				unpackInPlace(output + c*outputStride);
+			}
+		}
+		/// The output channels must not overlap each other, but can overlap the input
+		void ifftBatch(const complex *input, V *output, size_t channels, size_t inputStride, size_t outputStride) {
+			size_t hSize = complexFft.size();
+			if (outputStride%2) {
+				for (size_t c = 0; c < channels; ++c) {
+					ifft(input + c*inputStride, output + c*outputStride);
+				}
+				return;
+			}
+
+			reserveBatch(channels);
+			for (size_t c = 0; c < channels; ++c) {
+				packInto(input + c*inputStride, batchBuffer.data() + c*hSize);
+			}
+			complex *pairs = (complex *)output;
+			complexFft.ifftBatch(batchBuffer.data(), pairs, channels, hSize, outputStride/2);
+			for (size_t c = 0; c < channels; ++c) {
+				rotateOutput(pairs + c*outputStride/2);
+			}
+		}
+		/// @}
+
+		/// @name Split-complex (separate real/imaginary arrays for the `size()/2` bins)
+		/// @{
+		void fft(const V *input, V *outputReal, V *outputImag) {
+			size_t hSize = complexFft.size();
+			// Pairs of real samples are read directly as complex values
+			const complex *pairs = (const complex *)input;
+			if (modified) {
+				complexFft.fft(_fft_impl::RotatedIterator<V>{pairs, tables->modifiedRotations.data()}, outputReal, outputImag);
+			} else {
+				complexFft.fft(pairs, outputReal, outputImag);
+			}
+
+			// Unpack in-place, so each pair of bins is only visited once
+			if (!modified) {
+				V real0 = outputReal[0], imag0 = outputImag[0];
+				outputReal[0] = real0 + imag0;
+				outputImag[0] = real0 - imag0;
+			}
+			for (size_t i = modified ? 0 : 1; i <= hSize/2; ++i) {
+				size_t conjI = modified ? (hSize  - 1 - i) : (hSize - i);
+				if (modified && conjI == i + 1) continue; // same as the interleaved version
+				complex result, conjResult;
+				unpackPair(i, {outputReal[i], outputImag[i]}, {outputReal[conjI], outputImag[conjI]}, result, conjResult);
+				outputReal[i] = result.real();
+				outputImag[i] = result.imag();
+				outputReal[conjI] = conjResult.real();
+				outputImag[conjI] = conjResult.imag();
+			}
+		}
+
+		void ifft(const V *inputReal, const V *inputImag, V *output) {
+			packInto(_fft_impl::SplitIterator<V>{inputReal, inputImag}, complexBuffer1.data());
+
+			// The real output is written directly as pairs
+			ifftPairs((complex *)output);
+		}
+		/// @}
 	};
 
 	template<typename V>
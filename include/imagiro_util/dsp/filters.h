@@ -4,9 +4,16 @@
 #define SIGNALSMITH_DSP_FILTERS_H
 
 #include "./perf.h"
+#include "./fft.h"
 
 #include <cmath>
 #include <complex>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 namespace signalsmith {
 namespace filters {
@@ -34,7 +41,49 @@ namespace filters {
 		oneSided, ///< Based on `bilinear`, adjusting bandwidth to preserve the lower boundary (leaving the upper one loose).
 		vicanek ///< From Martin Vicanek's [Matched Second Order Digital Filters](https://vicanek.de/articles/BiquadFits.pdf).  Falls back to `oneSided` for shelf and allpass filters.  This takes the poles from the impulse-invariant approach, and then picks the zeros to create a better match.  This means that Nyquist is not 0dB for peak/notch (or -Inf for lowpass), but it is a decent match to the analogue prototype.
 	};
+
+	/// Normalised biquad coefficients (with `a0 = 1`), shared between `BiquadStatic` (with either bandwidth setting) and the other biquad classes
+	template<typename Sample>
+	struct BiquadCoefficients {
+		Sample b0, b1, b2, a1, a2;
+	};
 	
+	namespace _filters_impl {
+		/// `sin(pi*x)` for `x` in [0, 0.5], as a Taylor series (absolute error below 1e-7)
+		SIGNALSMITH_INLINE double fastSinPi(double x) {
+			double x2 = x*x;
+			return x*(3.141592653589793 + x2*(-5.167712780049969 + x2*(2.550164039877345 + x2*(-0.5992645293207919 + x2*(0.08214588661112819 + x2*-0.007370430945714348)))));
+		}
+		/// `2^x`, splitting off the integer part and using a Taylor series for the rest (relative error around 1e-8)
+		SIGNALSMITH_INLINE double fastExp2(double x) {
+			x = std::max(-1000.0, std::min(1000.0, x));
+			// Round to nearest, offset so the truncation is always of a positive number
+			int64_t whole = int64_t(x + 1000.5) - 1000;
+			double f = x - double(whole);
+			double fractional = 1 + f*(0.6931471805599453 + f*(0.2402265069591007 + f*(0.055504108664821576 + f*(0.009618129107628477 + f*(0.0013333558146428441 + f*(0.00015403530393381606 + f*1.5252733804059838e-05))))));
+			uint64_t bits = uint64_t(whole + 1023) << 52;
+			double power;
+			std::memcpy(&power, &bits, sizeof(power));
+			return fractional*power;
+		}
+		/// `log2(x)` for positive normal `x`, using the exponent bits and a series for the mantissa (absolute error around 2e-8)
+		SIGNALSMITH_INLINE double fastLog2(double x) {
+			uint64_t bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			int64_t exponent = int64_t((bits >> 52)&0x7FF) - 1023;
+			bits = (bits&0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+			double mantissa;
+			std::memcpy(&mantissa, &bits, sizeof(mantissa));
+			// log(m) = 2*atanh((m - 1)/(m + 1)), where the atanh() argument is at most 1/3
+			double t = (mantissa - 1)/(mantissa + 1), t2 = t*t;
+			double logM = 2*t*(1 + t2*(1.0/3 + t2*(1.0/5 + t2*(1.0/7 + t2*(1.0/9 + t2*(1.0/11 + t2*(1.0/13)))))));
+			return double(exponent) + logM*1.4426950408889634;
+		}
+	}
+
+	template<typename Sample, bool cookbookBandwidth>
+	class BiquadCascade;
+
 	/** A standard biquad.
 
 		This is not guaranteed to be stable if modulated at audio rate.
@@ -44,6 +93,8 @@ namespace filters {
 		Bandwidth compensation defaults to `BiquadDesign::oneSided` (or `BiquadDesign::cookbook` if `cookbookBandwidth` is enabled) for all filter types aside from highpass/lowpass (which use `BiquadDesign::bilinear`).*/
 	template<typename Sample, bool cookbookBandwidth=false>
 	class BiquadStatic {
+		friend class BiquadCascade<Sample, cookbookBandwidth>;
+
 		static constexpr BiquadDesign bwDesign = cookbookBandwidth ? BiquadDesign::cookbook : BiquadDesign::oneSided;
 		Sample a1 = 0, a2 = 0, b0 = 1, b1 = 0, b2 = 0;
 		Sample x1 = 0, x2 = 0, y1 = 0, y2 = 0;
@@ -241,6 +292,20 @@ namespace filters {
 		static constexpr double defaultQ = 0.7071067811865476; // sqrt(0.5)
 		static constexpr double defaultBandwidth = 1.8999686269529916; // equivalent to above Q
 
+		using Coefficients = BiquadCoefficients<Sample>;
+		Coefficients coefficients() const {
+			return {b0, b1, b2, a1, a2};
+		}
+		/// Sets the coefficients directly (e.g. from a `BiquadGrid`)
+		BiquadStatic & setCoefficients(const Coefficients &c) {
+			b0 = c.b0;
+			b1 = c.b1;
+			b2 = c.b2;
+			a1 = c.a1;
+			a2 = c.a2;
+			return *this;
+		}
+
 		Sample operator ()(Sample x0) {
 			Sample y0 = x0*b0 + x1*b1 + x2*b2 - y1*a1 - y2*a2;
 			y2 = y1;
@@ -431,6 +496,882 @@ namespace filters {
 		}
 	};
 
+	/** A biquad for modulated parameters, which glides between coefficients across each block.
+
+		The design methods (`.lowpassQ()`, `.peakDbQ()` etc.) match `BiquadStatic` with `BiquadDesign::bilinear`, but are cheap enough to call every few samples.  They use polynomial approximations for sin/cos/exp, and write the bilinear formulas in terms of sin/cos of *half* the angle, so there's only one division and (for the linear-gain shelves) a `std::sqrt()`.  Any other `BiquadStatic` design can be used with `.set()`.
+
+		These set the target, and the next `.process()` interpolates the coefficients linearly from their current values, reaching the target at the end of the block.  The stable region for (`a1`, `a2`) is a triangle, so if both ends are stable then everything in between is too (although fast modulation can still cause some overshoot).
+		\code
+			BiquadModulated<float> filter;
+			for (int start = 0; start < length; start += 16) {
+				filter.lowpassQ(cutoff(start + 16), 2);
+				filter.process(input + start, output + start, std::min(16, length - start));
+			}
+		\endcode
+	*/
+	template<typename Sample>
+	class BiquadModulated {
+		enum class Type {highpass, lowpass, highShelf, lowShelf, bandpass, notch, peak, allpass};
+
+		Sample b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+		Sample x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+		Sample tb0 = 1, tb1 = 0, tb2 = 0, ta1 = 0, ta2 = 0;
+
+		/* Same results as `BiquadStatic::configure()` for `BiquadDesign::bilinear`, but with every term scaled by (s^2 + c^2), where s/c are sin/cos of w0/2.  Then cos(w0) = c^2 - s^2, sin(w0) = 2sc, and 1 +/- cos(w0) become 2c^2 and 2s^2 (which stay accurate near Nyquist/DC).
+		`sqrtGain` is A in the cookbook formulas, and `rootA` is sqrt(A) (only used for shelves). */
+		SIGNALSMITH_INLINE BiquadModulated & fastConfigure(Type type, double scaledFreq, double q, double sqrtGain=1, double invSqrtGain=1, double rootA=1) {
+			scaledFreq = std::max(1e-6, std::min(0.4999, scaledFreq));
+			double s = _filters_impl::fastSinPi(scaledFreq), c = _filters_impl::fastSinPi(0.5 - scaledFreq);
+			double s2 = s*s, c2 = c*c, one = s2 + c2, cosW0 = c2 - s2;
+			double alpha = s*c/q; // sin(w0)/(2Q)
+			double A = sqrtGain;
+
+			double nb0, nb1, nb2, na0, na1, na2;
+			if (type == Type::highpass) {
+				nb1 = -2*c2;
+				nb0 = nb2 = c2;
+				na0 = one + alpha;
+				na1 = -2*cosW0;
+				na2 = one - alpha;
+			} else if (type == Type::lowpass) {
+				nb1 = 2*s2;
+				nb0 = nb2 = s2;
+				na0 = one + alpha;
+				na1 = -2*cosW0;
+				na2 = one - alpha;
+			} else if (type == Type::highShelf) {
+				// The shelves are also scaled by 1/2, so this is 2*sqrt(A)*alpha
+				double sqrtA2alpha = rootA*alpha;
+				nb0 = A*(A*c2 + s2 + sqrtA2alpha);
+				nb2 = A*(A*c2 + s2 - sqrtA2alpha);
+				nb1 = -2*A*(A*c2 - s2);
+				na0 = c2 + A*s2 + sqrtA2alpha;
+				na2 = c2 + A*s2 - sqrtA2alpha;
+				na1 = 2*(A*s2 - c2);
+			} else if (type == Type::lowShelf) {
+				double sqrtA2alpha = rootA*alpha;
+				nb0 = A*(c2 + A*s2 + sqrtA2alpha);
+				nb2 = A*(c2 + A*s2 - sqrtA2alpha);
+				nb1 = 2*A*(A*s2 - c2);
+				na0 = A*c2 + s2 + sqrtA2alpha;
+				na2 = A*c2 + s2 - sqrtA2alpha;
+				na1 = -2*(A*c2 - s2);
+			} else if (type == Type::bandpass) {
+				nb0 = alpha;
+				nb1 = 0;
+				nb2 = -alpha;
+				na0 = one + alpha;
+				na1 = -2*cosW0;
+				na2 = one - alpha;
+			} else if (type == Type::notch) {
+				nb0 = one;
+				nb1 = -2*cosW0;
+				nb2 = one;
+				na0 = one + alpha;
+				na1 = nb1;
+				na2 = one - alpha;
+			} else if (type == Type::peak) {
+				nb0 = one + alpha*A;
+				nb1 = -2*cosW0;
+				nb2 = one - alpha*A;
+				na0 = one + alpha*invSqrtGain;
+				na1 = nb1;
+				na2 = one - alpha*invSqrtGain;
+			} else {
+				// allpass
+				na0 = nb2 = one + alpha;
+				na1 = nb1 = -2*cosW0;
+				na2 = nb0 = one - alpha;
+			}
+			double invA0 = 1/na0;
+			tb0 = Sample(nb0*invA0);
+			tb1 = Sample(nb1*invA0);
+			tb2 = Sample(nb2*invA0);
+			ta1 = Sample(na1*invA0);
+			ta2 = Sample(na2*invA0);
+			return *this;
+		}
+		/// Configures a peak/shelf from a linear gain (of which A is the square root)
+		SIGNALSMITH_INLINE BiquadModulated & fastGain(Type type, double scaledFreq, double gain, double q) {
+			double A = std::sqrt(gain);
+			return fastConfigure(type, scaledFreq, q, A, 1/A, std::sqrt(A));
+		}
+		SIGNALSMITH_INLINE BiquadModulated & fastGainDb(Type type, double scaledFreq, double db, double q) {
+			double log2A = db*0.08304820237218405; // log2(10)/40
+			return fastConfigure(type, scaledFreq, q, _filters_impl::fastExp2(log2A), _filters_impl::fastExp2(-log2A), _filters_impl::fastExp2(log2A*0.5));
+		}
+	public:
+		static constexpr double defaultQ = 0.7071067811865476; // sqrt(0.5)
+
+		/// Processes a block, gliding the coefficients to the target.  This can be in-place.
+		template<class InputData, class OutputData>
+		void process(InputData &&input, OutputData &&output, int length) {
+			if (length <= 0) return;
+			Sample invLength = Sample(1)/length;
+			Sample db0 = (tb0 - b0)*invLength, db1 = (tb1 - b1)*invLength, db2 = (tb2 - b2)*invLength;
+			Sample da1 = (ta1 - a1)*invLength, da2 = (ta2 - a2)*invLength;
+			// Sample i uses the current coefficients plus (i + 1) steps, so the last sample uses the target
+			Sample c0 = b0, c1 = b1, c2 = b2, d1 = a1, d2 = a2;
+			for (int i = 0; i < length; ++i) {
+				c0 += db0;
+				c1 += db1;
+				c2 += db2;
+				d1 += da1;
+				d2 += da2;
+				Sample x0 = input[i];
+				Sample y0 = x0*c0 + x1*c1 + x2*c2 - y1*d1 - y2*d2;
+				y2 = y1;
+				y1 = y0;
+				x2 = x1;
+				x1 = x0;
+				output[i] = y0;
+			}
+			snap();
+		}
+		/// Single sample, using the current coefficients (see `.snap()`)
+		Sample operator ()(Sample x0) {
+			Sample y0 = x0*b0 + x1*b1 + x2*b2 - y1*a1 - y2*a2;
+			y2 = y1;
+			y1 = y0;
+			x2 = x1;
+			x1 = x0;
+			return y0;
+		}
+
+		/// Jumps straight to the target coefficients, with no interpolation
+		BiquadModulated & snap() {
+			b0 = tb0;
+			b1 = tb1;
+			b2 = tb2;
+			a1 = ta1;
+			a2 = ta2;
+			return *this;
+		}
+		void reset() {
+			x1 = x2 = y1 = y2 = 0;
+		}
+
+		/// Sets the target from any `BiquadStatic` design (but not its state)
+		template<bool cookbookBandwidth>
+		BiquadModulated & set(const BiquadStatic<Sample, cookbookBandwidth> &filter) {
+			return setCoefficients(filter.coefficients());
+		}
+		/// Sets the target coefficients directly (e.g. from a `BiquadGrid`)
+		BiquadModulated & setCoefficients(const BiquadCoefficients<Sample> &c) {
+			tb0 = c.b0;
+			tb1 = c.b1;
+			tb2 = c.b2;
+			ta1 = c.a1;
+			ta2 = c.a2;
+			return *this;
+		}
+		/// The target coefficients
+		BiquadCoefficients<Sample> target() const {
+			return {tb0, tb1, tb2, ta1, ta2};
+		}
+		/// Response of the target filter
+		std::complex<Sample> response(Sample scaledFreq) const {
+			Sample w = scaledFreq*Sample(2*M_PI);
+			std::complex<Sample> invZ = {std::cos(w), -std::sin(w)}, invZ2 = invZ*invZ;
+			return (tb0 + invZ*tb1 + invZ2*tb2)/(Sample(1) + invZ*ta1 + invZ2*ta2);
+		}
+
+		BiquadModulated & lowpassQ(double scaledFreq, double q=defaultQ) {
+			return fastConfigure(Type::lowpass, scaledFreq, q);
+		}
+		BiquadModulated & highpassQ(double scaledFreq, double q=defaultQ) {
+			return fastConfigure(Type::highpass, scaledFreq, q);
+		}
+		BiquadModulated & bandpassQ(double scaledFreq, double q) {
+			return fastConfigure(Type::bandpass, scaledFreq, q);
+		}
+		BiquadModulated & notchQ(double scaledFreq, double q) {
+			return fastConfigure(Type::notch, scaledFreq, q);
+		}
+		BiquadModulated & allpassQ(double scaledFreq, double q) {
+			return fastConfigure(Type::allpass, scaledFreq, q);
+		}
+		BiquadModulated & peakQ(double scaledFreq, double gain, double q) {
+			return fastGain(Type::peak, scaledFreq, gain, q);
+		}
+		BiquadModulated & peakDbQ(double scaledFreq, double db, double q) {
+			return fastGainDb(Type::peak, scaledFreq, db, q);
+		}
+		BiquadModulated & highShelfQ(double scaledFreq, double gain, double q=defaultQ) {
+			return fastGain(Type::highShelf, scaledFreq, gain, q);
+		}
+		BiquadModulated & highShelfDbQ(double scaledFreq, double db, double q=defaultQ) {
+			return fastGainDb(Type::highShelf, scaledFreq, db, q);
+		}
+		BiquadModulated & lowShelfQ(double scaledFreq, double gain, double q=defaultQ) {
+			return fastGain(Type::lowShelf, scaledFreq, gain, q);
+		}
+		BiquadModulated & lowShelfDbQ(double scaledFreq, double db, double q=defaultQ) {
+			return fastGainDb(Type::lowShelf, scaledFreq, db, q);
+		}
+	};
+
+	namespace _filters_impl {
+		/** Runs 8 biquads along a block, with the samples interleaved (`data[i*8 + lane]`).
+		The coefficients are `{b0[8], b1[8], b2[8], a1[8], a2[8]}` and the state is `{x1[8], x2[8], y1[8], y2[8]}`. */
+		template<typename Sample>
+		void biquadLanesScalar(Sample *data, int length, const Sample *coeffs, Sample *state) {
+			for (int l = 0; l < 8; ++l) {
+				Sample b0 = coeffs[l], b1 = coeffs[8 + l], b2 = coeffs[16 + l], a1 = coeffs[24 + l], a2 = coeffs[32 + l];
+				Sample x1 = state[l], x2 = state[8 + l], y1 = state[16 + l], y2 = state[24 + l];
+				for (int i = 0; i < length; ++i) {
+					Sample x0 = data[i*8 + l];
+					Sample y0 = x0*b0 + x1*b1 + x2*b2 - y1*a1 - y2*a2;
+					y2 = y1;
+					y1 = y0;
+					x2 = x1;
+					x1 = x0;
+					data[i*8 + l] = y0;
+				}
+				state[l] = x1;
+				state[8 + l] = x2;
+				state[16 + l] = y1;
+				state[24 + l] = y2;
+			}
+		}
+
+#if defined(SIGNALSMITH_FFT_SSE2) || defined(SIGNALSMITH_FFT_NEON)
+		// Uses the SIMD packs from the FFT, with one copy per instruction set.  The operations are in the same order as `BiquadStatic`, so the results match.
+#define SIGNALSMITH_FILTERS_SIMD_BIQUAD(TARGET) \
+		template<class Pack, typename Sample> \
+		TARGET void biquadLanes(Sample *data, int length, const Sample *coeffs, Sample *state) { \
+			using V = typename Pack::V; \
+			constexpr int width = int(Pack::width*2), packs = 8/width; \
+			V b0[packs], b1[packs], b2[packs], a1[packs], a2[packs]; \
+			V x1[packs], x2[packs], y1[packs], y2[packs]; \
+			for (int p = 0; p < packs; ++p) { \
+				b0[p] = Pack::loadReals(coeffs + p*width); \
+				b1[p] = Pack::loadReals(coeffs + 8 + p*width); \
+				b2[p] = Pack::loadReals(coeffs + 16 + p*width); \
+				a1[p] = Pack::loadReals(coeffs + 24 + p*width); \
+				a2[p] = Pack::loadReals(coeffs + 32 + p*width); \
+				x1[p] = Pack::loadReals(state + p*width); \
+				x2[p] = Pack::loadReals(state + 8 + p*width); \
+				y1[p] = Pack::loadReals(state + 16 + p*width); \
+				y2[p] = Pack::loadReals(state + 24 + p*width); \
+			} \
+			for (int i = 0; i < length; ++i) { \
+				for (int p = 0; p < packs; ++p) { \
+					V x0 = Pack::loadReals(data + i*8 + p*width); \
+					V sum = Pack::add(Pack::add(Pack::mul(x0, b0[p]), Pack::mul(x1[p], b1[p])), Pack::mul(x2[p], b2[p])); \
+					V y0 = Pack::sub(Pack::sub(sum, Pack::mul(y1[p], a1[p])), Pack::mul(y2[p], a2[p])); \
+					y2[p] = y1[p]; \
+					y1[p] = y0; \
+					x2[p] = x1[p]; \
+					x1[p] = x0; \
+					Pack::storeReals(data + i*8 + p*width, y0); \
+				} \
+			} \
+			for (int p = 0; p < packs; ++p) { \
+				Pack::storeReals(state + p*width, x1[p]); \
+				Pack::storeReals(state + 8 + p*width, x2[p]); \
+				Pack::storeReals(state + 16 + p*width, y1[p]); \
+				Pack::storeReals(state + 24 + p*width, y2[p]); \
+			} \
+		}
+		namespace _simd_native {
+			SIGNALSMITH_FILTERS_SIMD_BIQUAD()
+		}
+#	ifdef SIGNALSMITH_FFT_AVX2
+		namespace _simd_avx2 {
+			SIGNALSMITH_FILTERS_SIMD_BIQUAD(SIGNALSMITH_FFT_AVX2)
+		}
+#	endif
+#undef SIGNALSMITH_FILTERS_SIMD_BIQUAD
+#endif
+
+		template<typename Sample>
+		using BiquadLanes = void (*)(Sample *data, int length, const Sample *coeffs, Sample *state);
+
+		template<typename Sample>
+		BiquadLanes<Sample> chooseBiquadLanes(Sample *) {
+			return biquadLanesScalar<Sample>;
+		}
+#ifdef SIGNALSMITH_FFT_SSE2
+		inline BiquadLanes<float> chooseBiquadLanes(float *) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (::signalsmith::fft::_fft_impl::cpuSupportsAvx2()) return _simd_avx2::biquadLanes<::signalsmith::fft::_fft_impl::PackAvx2Float, float>;
+#	endif
+			return _simd_native::biquadLanes<::signalsmith::fft::_fft_impl::PackSse2Float, float>;
+		}
+		inline BiquadLanes<double> chooseBiquadLanes(double *) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (::signalsmith::fft::_fft_impl::cpuSupportsAvx2()) return _simd_avx2::biquadLanes<::signalsmith::fft::_fft_impl::PackAvx2Double, double>;
+#	endif
+			return _simd_native::biquadLanes<::signalsmith::fft::_fft_impl::PackSse2Double, double>;
+		}
+#elif defined(SIGNALSMITH_FFT_NEON)
+		inline BiquadLanes<float> chooseBiquadLanes(float *) {
+			return _simd_native::biquadLanes<::signalsmith::fft::_fft_impl::PackNeonFloat, float>;
+		}
+		inline BiquadLanes<double> chooseBiquadLanes(double *) {
+			return _simd_native::biquadLanes<::signalsmith::fft::_fft_impl::PackNeonDouble, double>;
+		}
+#endif
+	}
+
+	/** A bank of independent biquads (e.g. one per channel or voice), with the coefficients and state stored across filters so they can be processed in SIMD lanes.
+
+		The coefficients are copied from `BiquadStatic`, so any of its designs can be used:
+		\code
+			BiquadBank<float, 64> bank;
+			bank.set(0, BiquadStatic<float>().lowpass(0.1));
+			bank.set(1, BiquadStatic<float>().peakDb(0.05, 6));
+		\endcode
+		Filters start out neutral (passing their input through unchanged).
+
+		The block `.process()` runs groups of 8 filters together, interleaving chunks of their input so each sample step is a few SIMD operations across the group.  The results match running each filter through `BiquadStatic` (unless the compiler contracts that into fused multiply-adds).
+	*/
+	template<typename Sample, int filterCount>
+	class BiquadBank {
+		static_assert(filterCount > 0, "BiquadBank needs at least one filter");
+		static constexpr int lanes = 8, groups = (filterCount + lanes - 1)/lanes;
+		// Block length for the interleaved input/output of one group
+		static constexpr int chunkLength = 64;
+
+		// Indexed by [group][b0/b1/b2/a1/a2][lane]
+		std::array<Sample, groups*lanes*5> coeffs;
+		// Indexed by [group][x1/x2/y1/y2][lane]
+		std::array<Sample, groups*lanes*4> state;
+		_filters_impl::BiquadLanes<Sample> biquadLanes = _filters_impl::chooseBiquadLanes((Sample *)nullptr);
+
+		Sample & coeff(int index, int k) {
+			return coeffs[(index/lanes)*lanes*5 + k*lanes + index%lanes];
+		}
+		Sample & stateValue(int index, int k) {
+			return state[(index/lanes)*lanes*4 + k*lanes + index%lanes];
+		}
+	public:
+		static constexpr int size = filterCount;
+
+		BiquadBank() {
+			for (int i = 0; i < groups*lanes; ++i) {
+				setCoefficients(i, 1, 0, 0, 0, 0);
+			}
+			reset();
+		}
+
+		/// Copies the coefficients from a `BiquadStatic` design (but not its state)
+		template<bool cookbookBandwidth>
+		BiquadBank & set(int index, const BiquadStatic<Sample, cookbookBandwidth> &filter) {
+			return setCoefficients(index, filter.coefficients());
+		}
+		BiquadBank & setCoefficients(int index, const BiquadCoefficients<Sample> &c) {
+			return setCoefficients(index, c.b0, c.b1, c.b2, c.a1, c.a2);
+		}
+		/// Sets normalised coefficients (with `a0 = 1`) directly
+		BiquadBank & setCoefficients(int index, Sample b0, Sample b1, Sample b2, Sample a1, Sample a2) {
+			coeff(index, 0) = b0;
+			coeff(index, 1) = b1;
+			coeff(index, 2) = b2;
+			coeff(index, 3) = a1;
+			coeff(index, 4) = a2;
+			return *this;
+		}
+
+		void reset() {
+			state.fill(0);
+		}
+		void reset(int index) {
+			for (int k = 0; k < 4; ++k) stateValue(index, k) = 0;
+		}
+
+		/// Processes a single sample for each filter (`output[i]` from `input[i]`)
+		template<class InputFrame, class OutputFrame>
+		void processFrame(InputFrame &&input, OutputFrame &&output) {
+			for (int g = 0; g < groups; ++g) {
+				const Sample *c = coeffs.data() + g*lanes*5;
+				Sample *s = state.data() + g*lanes*4;
+				int groupFilters = std::min(lanes, filterCount - g*lanes);
+				for (int l = 0; l < groupFilters; ++l) {
+					Sample x0 = input[g*lanes + l];
+					Sample y0 = x0*c[l] + s[l]*c[lanes + l] + s[lanes + l]*c[2*lanes + l] - s[2*lanes + l]*c[3*lanes + l] - s[3*lanes + l]*c[4*lanes + l];
+					s[3*lanes + l] = s[2*lanes + l];
+					s[2*lanes + l] = y0;
+					s[lanes + l] = s[l];
+					s[l] = x0;
+					output[g*lanes + l] = y0;
+				}
+			}
+		}
+
+		/// Processes a block for each filter (`output[i][t]` from `input[i][t]`).  This can be in-place.
+		template<class InputData, class OutputData>
+		void process(InputData &&input, OutputData &&output, int length) {
+			Sample interleaved[chunkLength*lanes];
+			for (int g = 0; g < groups; ++g) {
+				const Sample *c = coeffs.data() + g*lanes*5;
+				Sample *s = state.data() + g*lanes*4;
+				int groupFilters = std::min(lanes, filterCount - g*lanes);
+				if (groupFilters < lanes) {
+					for (int i = 0; i < chunkLength*lanes; ++i) interleaved[i] = 0;
+				}
+				for (int start = 0; start < length; start += chunkLength) {
+					int count = std::min(chunkLength, length - start);
+					for (int l = 0; l < groupFilters; ++l) {
+						auto &&channel = input[g*lanes + l];
+						for (int i = 0; i < count; ++i) {
+							interleaved[i*lanes + l] = channel[start + i];
+						}
+					}
+					biquadLanes(interleaved, count, c, s);
+					for (int l = 0; l < groupFilters; ++l) {
+						auto &&channel = output[g*lanes + l];
+						for (int i = 0; i < count; ++i) {
+							channel[start + i] = interleaved[i*lanes + l];
+						}
+					}
+				}
+			}
+		}
+		
+		std::complex<Sample> response(int index, Sample scaledFreq) const {
+			const Sample *c = coeffs.data() + (index/lanes)*lanes*5 + index%lanes;
+			Sample w = scaledFreq*Sample(2*M_PI);
+			std::complex<Sample> invZ = {std::cos(w), -std::sin(w)}, invZ2 = invZ*invZ;
+			return (c[0] + invZ*c[lanes] + invZ2*c[2*lanes])/(Sample(1) + invZ*c[3*lanes] + invZ2*c[4*lanes]);
+		}
+	};
+
+	/** A precomputed grid of `BiquadStatic` coefficients across frequency and Q, for one filter type/design (and gain).
+
+		Looking up coefficients interpolates (bilinearly) between the four surrounding grid points, which is a few loads and multiplies instead of a full design.  Frequency and Q are both spaced logarithmically (`Spec::freqSteps`/`Spec::qSteps` points per octave), so this suits parameters which are already quantised, like synth cutoffs/resonance.  If those are already on a log scale (e.g. MIDI notes), `.at()` takes grid positions directly, which skips the `log2()`s.  The stable region for (`a1`, `a2`) is a triangle, so interpolating between stable designs is also stable.
+
+		Grids are built the first time a `Spec` is used, and shared (immutable) between all grids with the same `Spec`.  Use `.measureError()` to check the accuracy against the exact design, and `.memoryBytes()` for the size, when choosing the resolution.
+		\code
+			BiquadGrid<float>::Spec spec;
+			spec.type = BiquadGrid<float>::Type::lowpass;
+			spec.qSteps = 8;
+			BiquadGrid<float> grid(spec);
+			filter.setCoefficients(grid(cutoff, q));
+		\endcode
+	*/
+	template<typename Sample, bool cookbookBandwidth=false>
+	class BiquadGrid {
+	public:
+		using Coefficients = BiquadCoefficients<Sample>;
+		enum class Type {highpass, lowpass, highShelf, lowShelf, bandpass, notch, peak, allpass};
+
+		struct Spec {
+			Type type = Type::lowpass;
+			BiquadDesign design = BiquadDesign::bilinear;
+			/// Only used for the peak/shelf types
+			double db = 0;
+			double lowFreq = 1e-4, highFreq = 0.49;
+			double lowQ = 0.1, highQ = 20;
+			/// Grid points per octave
+			double freqSteps = 12, qSteps = 4;
+
+			bool operator==(const Spec &other) const {
+				return type == other.type && design == other.design && db == other.db && lowFreq == other.lowFreq && highFreq == other.highFreq && lowQ == other.lowQ && highQ == other.highQ && freqSteps == other.freqSteps && qSteps == other.qSteps;
+			}
+		};
+
+		/// Errors (in dB) of the interpolated responses, relative to the exact design
+		struct Error {
+			double peakDb, rmsDb;
+		};
+
+		BiquadGrid() : BiquadGrid(Spec()) {}
+		BiquadGrid(const Spec &spec) : table(SharedTables::get(spec)) {}
+
+		const Spec & spec() const {
+			return table->spec;
+		}
+		size_t memoryBytes() const {
+			return table->coefficients.size()*sizeof(Sample);
+		}
+
+		/// Interpolated coefficients, with frequency/Q clamped to the grid's range.  This uses a fast `log2()` approximation for the grid position.
+		SIGNALSMITH_INLINE Coefficients operator ()(double scaledFreq, double q) const {
+			const Table &t = *table;
+			double freqIndex = (_filters_impl::fastLog2(std::max(scaledFreq, 1e-300)) - t.log2LowFreq)*t.spec.freqSteps;
+			double qIndex = (_filters_impl::fastLog2(std::max(q, 1e-300)) - t.log2LowQ)*t.spec.qSteps;
+			return at(freqIndex, qIndex);
+		}
+		/// Interpolated coefficients at a (fractional) grid position, which is clamped to the grid.  Index 0 is `Spec::lowFreq`/`Spec::lowQ`, and each index is `1/freqSteps` (or `1/qSteps`) octaves higher.
+		SIGNALSMITH_INLINE Coefficients at(double freqIndex, double qIndex) const {
+			const Table &t = *table;
+			freqIndex = std::max(0.0, std::min(double(t.freqPoints - 1), freqIndex));
+			qIndex = std::max(0.0, std::min(double(t.qPoints - 1), qIndex));
+			int fi = std::min(int(freqIndex), t.freqPoints - 2), qi = std::min(int(qIndex), t.qPoints - 2);
+			Sample fr = Sample(freqIndex - fi), qr = Sample(qIndex - qi);
+			const Sample *low = t.coefficients.data() + (fi*t.qPoints + qi)*5;
+			const Sample *high = low + t.qPoints*5;
+			return {
+				interpolate(low, high, 0, fr, qr),
+				interpolate(low, high, 1, fr, qr),
+				interpolate(low, high, 2, fr, qr),
+				interpolate(low, high, 3, fr, qr),
+				interpolate(low, high, 4, fr, qr)
+			};
+		}
+
+		/** Compares the interpolated responses against the exact design, at `subdivisions` points between each pair of grid points (in both directions).
+		Responses are compared (in dB) at log-spaced frequencies, ignoring anything more than `floorDb` below 0dB. */
+		Error measureError(int subdivisions=2, double floorDb=-60) const {
+			const Table &t = *table;
+			double peak = 0, sum2 = 0;
+			size_t count = 0;
+			BiquadStatic<Sample, cookbookBandwidth> exact, interpolated;
+			for (int fi = 0; fi < (t.freqPoints - 1)*subdivisions + 1; ++fi) {
+				for (int qi = 0; qi < (t.qPoints - 1)*subdivisions + 1; ++qi) {
+					double freqIndex = double(fi)/subdivisions, qIndex = double(qi)/subdivisions;
+					t.design(exact, t.freqAt(freqIndex), t.qAt(qIndex));
+					interpolated.setCoefficients(at(freqIndex, qIndex));
+					for (double probe = 1e-4; probe < 0.5; probe *= 1.1) {
+						double exactDb = std::max(floorDb, double(exact.responseDb(probe)));
+						double interpolatedDb = std::max(floorDb, double(interpolated.responseDb(probe)));
+						double diff = std::abs(exactDb - interpolatedDb);
+						peak = std::max(peak, diff);
+						sum2 += diff*diff;
+						++count;
+					}
+				}
+			}
+			return {peak, std::sqrt(sum2/count)};
+		}
+	private:
+		SIGNALSMITH_INLINE static Sample interpolate(const Sample *low, const Sample *high, int k, Sample fr, Sample qr) {
+			Sample lowF = low[k] + (low[k + 5] - low[k])*qr;
+			Sample highF = high[k] + (high[k + 5] - high[k])*qr;
+			return lowF + (highF - lowF)*fr;
+		}
+
+		// Immutable, and shared between grids with the same `Spec`
+		struct Table {
+			Spec spec;
+			int freqPoints, qPoints;
+			double log2LowFreq, log2LowQ;
+			// Indexed by [freq][q][b0/b1/b2/a1/a2]
+			std::vector<Sample> coefficients;
+
+			Table(const Spec &spec) : spec(spec) {
+				log2LowFreq = std::log2(spec.lowFreq);
+				log2LowQ = std::log2(spec.lowQ);
+				freqPoints = std::max(2, int(std::ceil((std::log2(spec.highFreq) - log2LowFreq)*spec.freqSteps)) + 1);
+				qPoints = std::max(2, int(std::ceil((std::log2(spec.highQ) - log2LowQ)*spec.qSteps)) + 1);
+				coefficients.resize(size_t(freqPoints)*qPoints*5);
+
+				BiquadStatic<Sample, cookbookBandwidth> filter;
+				for (int fi = 0; fi < freqPoints; ++fi) {
+					for (int qi = 0; qi < qPoints; ++qi) {
+						auto c = design(filter, freqAt(fi), qAt(qi)).coefficients();
+						Sample *point = coefficients.data() + (fi*qPoints + qi)*5;
+						point[0] = c.b0;
+						point[1] = c.b1;
+						point[2] = c.b2;
+						point[3] = c.a1;
+						point[4] = c.a2;
+					}
+				}
+			}
+
+			double freqAt(double index) const {
+				return std::exp2(log2LowFreq + index/spec.freqSteps);
+			}
+			double qAt(double index) const {
+				return std::exp2(log2LowQ + index/spec.qSteps);
+			}
+			BiquadStatic<Sample, cookbookBandwidth> & design(BiquadStatic<Sample, cookbookBandwidth> &filter, double freq, double q) const {
+				switch (spec.type) {
+					case Type::highpass: return filter.highpassQ(freq, q, spec.design);
+					case Type::lowpass: return filter.lowpassQ(freq, q, spec.design);
+					case Type::highShelf: return filter.highShelfDbQ(freq, spec.db, q, spec.design);
+					case Type::lowShelf: return filter.lowShelfDbQ(freq, spec.db, q, spec.design);
+					case Type::bandpass: return filter.bandpassQ(freq, q, spec.design);
+					case Type::notch: return filter.notchQ(freq, q, spec.design);
+					case Type::peak: return filter.peakDbQ(freq, spec.db, q, spec.design);
+					case Type::allpass: return filter.allpassQ(freq, q, spec.design);
+				}
+				return filter;
+			}
+		};
+		using SharedTables = signalsmith::fft::_fft_impl::SharedTables<Table, Spec>;
+		std::shared_ptr<const Table> table;
+	};
+
+	/** A cascade of biquads (second-order sections) in series, for EQs and higher-order filters.
+
+		Each section is a `BiquadStatic`, so can use any of its designs:
+		\code
+			BiquadCascade<float> eq(8);
+			eq[0].lowShelfDb(0.005, 3);
+			eq[1].peakDb(0.02, -2);
+			...
+			eq.process(input, output, length);
+		\endcode
+
+		The block `.process()` runs the sections over the block in groups of 4, keeping their state in registers.  The sections in a group still feed each other sample-by-sample, but their four recurrences can overlap, instead of each sample waiting for the whole chain (or one section at a time waiting on its own feedback).  The results match running the sections one after another.
+	*/
+	template<typename Sample, bool cookbookBandwidth=false>
+	class BiquadCascade {
+		using Section = BiquadStatic<Sample, cookbookBandwidth>;
+		// Processed in chunks of this length, so the block stays in cache between groups
+		static constexpr int chunkLength = 256;
+		std::vector<Section> sections;
+
+		template<int count>
+		static void processGroup(Section *group, Sample *data, int length) {
+			Sample b0[count], b1[count], b2[count], a1[count], a2[count];
+			Sample x1[count], x2[count], y1[count], y2[count];
+			for (int k = 0; k < count; ++k) {
+				const Section &s = group[k];
+				b0[k] = s.b0;
+				b1[k] = s.b1;
+				b2[k] = s.b2;
+				a1[k] = s.a1;
+				a2[k] = s.a2;
+				x1[k] = s.x1;
+				x2[k] = s.x2;
+				y1[k] = s.y1;
+				y2[k] = s.y2;
+			}
+			for (int i = 0; i < length; ++i) {
+				Sample x0 = data[i];
+				for (int k = 0; k < count; ++k) {
+					Sample y0 = x0*b0[k] + x1[k]*b1[k] + x2[k]*b2[k] - y1[k]*a1[k] - y2[k]*a2[k];
+					y2[k] = y1[k];
+					y1[k] = y0;
+					x2[k] = x1[k];
+					x1[k] = x0;
+					x0 = y0;
+				}
+				data[i] = x0;
+			}
+			for (int k = 0; k < count; ++k) {
+				Section &s = group[k];
+				s.x1 = x1[k];
+				s.x2 = x2[k];
+				s.y1 = y1[k];
+				s.y2 = y2[k];
+			}
+		}
+	public:
+		BiquadCascade(int size=0) : sections(size) {}
+
+		void resize(int size) {
+			sections.resize(size);
+		}
+		int size() const {
+			return int(sections.size());
+		}
+		Section & operator[](int index) {
+			return sections[index];
+		}
+		const Section & operator[](int index) const {
+			return sections[index];
+		}
+
+		void reset() {
+			for (auto &section : sections) section.reset();
+		}
+
+		/// Single sample, through every section
+		Sample operator ()(Sample x) {
+			for (auto &section : sections) x = section(x);
+			return x;
+		}
+
+		/// Processes a block through every section.  This can be in-place.
+		template<class InputData, class OutputData>
+		void process(InputData &&input, OutputData &&output, int length) {
+			Sample chunk[chunkLength];
+			const int count = int(sections.size());
+			for (int start = 0; start < length; start += chunkLength) {
+				int chunkSize = std::min(chunkLength, length - start);
+				for (int i = 0; i < chunkSize; ++i) chunk[i] = input[start + i];
+				int k = 0;
+				for (; k + 4 <= count; k += 4) processGroup<4>(sections.data() + k, chunk, chunkSize);
+				if (count - k == 3) processGroup<3>(sections.data() + k, chunk, chunkSize);
+				if (count - k == 2) processGroup<2>(sections.data() + k, chunk, chunkSize);
+				if (count - k == 1) processGroup<1>(sections.data() + k, chunk, chunkSize);
+				for (int i = 0; i < chunkSize; ++i) output[start + i] = chunk[i];
+			}
+		}
+
+		std::complex<Sample> response(Sample scaledFreq) const {
+			std::complex<Sample> result = 1;
+			for (auto &section : sections) result *= section.response(scaledFreq);
+			return result;
+		}
+		Sample responseDb(Sample scaledFreq) const {
+			return 10*std::log10(std::norm(response(scaledFreq)));
+		}
+	};
+
+	/** A sum of biquads (plus a direct gain), all fed the same input, converted from a `BiquadCascade`.
+
+		This is the partial-fraction expansion of the cascade's transfer function, with each section holding a pair of poles.  Since the sections are independent, they run in SIMD lanes (8 at a time), so a higher-order filter costs roughly the same as a few single sections.
+
+		The conversion needs the poles to be distinct (so not two identical sections, like a Linkwitz-Riley crossover), and no section with more zeros than poles.  Clustered poles (e.g. very narrow or low-frequency high-order designs) give large residues which partly cancel, so check the response if precision matters.
+	*/
+	template<typename Sample>
+	class BiquadParallel {
+		using Coefficients = BiquadCoefficients<Sample>;
+		static constexpr int lanes = 8, chunkLength = 64;
+		Sample direct = 0;
+		int sectionCount = 0, groups = 0;
+		// Indexed by [group][b0/b1/b2/a1/a2][lane], and [group][x1/x2/y1/y2][lane]
+		std::vector<Sample> coeffs, state;
+		_filters_impl::BiquadLanes<Sample> biquadLanes = _filters_impl::chooseBiquadLanes((Sample *)nullptr);
+
+		using Complex = std::complex<double>;
+		struct Pole {
+			Complex pole;
+			int section;
+		};
+		// The denominator of section `k`, at `w = 1/z`
+		static Complex evalDenominator(const Coefficients &c, Complex w) {
+			return 1.0 + w*(double(c.a1) + w*double(c.a2));
+		}
+		static Complex evalNumerator(const Coefficients &c, Complex w) {
+			return double(c.b0) + w*(double(c.b1) + w*double(c.b2));
+		}
+	public:
+		BiquadParallel() {}
+		template<bool cookbookBandwidth>
+		BiquadParallel(const BiquadCascade<Sample, cookbookBandwidth> &cascade) {
+			set(cascade);
+		}
+
+		/// Converts from a cascade, and resets the state.  Returns `false` (leaving this unchanged) if the cascade can't be converted.
+		template<bool cookbookBandwidth>
+		bool set(const BiquadCascade<Sample, cookbookBandwidth> &cascade) {
+			const int count = cascade.size();
+			std::vector<Coefficients> designs(count);
+			std::vector<Pole> poles;
+			double newDirect = 1;
+			for (int k = 0; k < count; ++k) {
+				Coefficients c = designs[k] = cascade[k].coefficients();
+				// H(w) as w -> infinity, for the direct term.  The numerator can't have a higher order than the denominator.
+				if (c.a2 != 0) {
+					newDirect *= double(c.b2)/c.a2;
+					Complex root = std::sqrt(Complex(double(c.a1)*c.a1 - 4.0*c.a2));
+					poles.push_back({(-double(c.a1) + root)*0.5, k});
+					poles.push_back({(-double(c.a1) - root)*0.5, k});
+				} else if (c.a1 != 0) {
+					if (c.b2 != 0) return false;
+					newDirect *= double(c.b1)/c.a1;
+					poles.push_back({Complex(-double(c.a1)), k});
+				} else {
+					if (c.b1 != 0 || c.b2 != 0) return false;
+					newDirect *= c.b0;
+				}
+			}
+			for (size_t i = 0; i < poles.size(); ++i) {
+				for (size_t j = i + 1; j < poles.size(); ++j) {
+					if (std::abs(poles[i].pole - poles[j].pole) < 1e-9) return false;
+				}
+			}
+
+			// Residues: H(w)*(1 - p*w) at w = 1/p
+			std::vector<Complex> residues(poles.size());
+			for (size_t i = 0; i < poles.size(); ++i) {
+				Complex p = poles[i].pole, w = 1.0/p;
+				Complex numerator = 1, denominator = 1;
+				for (int k = 0; k < count; ++k) {
+					numerator *= evalNumerator(designs[k], w);
+					if (k != poles[i].section) denominator *= evalDenominator(designs[k], w);
+				}
+				// The rest of this pole's own section
+				for (size_t j = 0; j < poles.size(); ++j) {
+					if (j != i && poles[j].section == poles[i].section) denominator *= 1.0 - poles[j].pole*w;
+				}
+				residues[i] = numerator/denominator;
+			}
+
+			// Each section's poles (and their residues) become one parallel section
+			std::vector<Coefficients> parallel;
+			for (size_t i = 0; i < poles.size(); ++i) {
+				if (i + 1 < poles.size() && poles[i + 1].section == poles[i].section) {
+					Complex p1 = poles[i].pole, p2 = poles[i + 1].pole, r1 = residues[i], r2 = residues[i + 1];
+					parallel.push_back({
+						Sample((r1 + r2).real()), Sample(-(r1*p2 + r2*p1).real()), 0,
+						Sample(-(p1 + p2).real()), Sample((p1*p2).real())
+					});
+					++i;
+				} else {
+					parallel.push_back({Sample(residues[i].real()), 0, 0, Sample(-poles[i].pole.real()), 0});
+				}
+			}
+
+			direct = Sample(newDirect);
+			sectionCount = int(parallel.size());
+			groups = (sectionCount + lanes - 1)/lanes;
+			// Unused lanes are all zeros, so output nothing
+			coeffs.assign(groups*lanes*5, 0);
+			for (int k = 0; k < sectionCount; ++k) {
+				Sample *c = coeffs.data() + (k/lanes)*lanes*5 + k%lanes;
+				c[0] = parallel[k].b0;
+				c[lanes] = parallel[k].b1;
+				c[2*lanes] = parallel[k].b2;
+				c[3*lanes] = parallel[k].a1;
+				c[4*lanes] = parallel[k].a2;
+			}
+			state.assign(groups*lanes*4, 0);
+			return true;
+		}
+
+		void reset() {
+			state.assign(state.size(), 0);
+		}
+
+		int size() const {
+			return sectionCount;
+		}
+		Sample directGain() const {
+			return direct;
+		}
+		Coefficients section(int index) const {
+			const Sample *c = coeffs.data() + (index/lanes)*lanes*5 + index%lanes;
+			return {c[0], c[lanes], c[2*lanes], c[3*lanes], c[4*lanes]};
+		}
+
+		/// Processes a block.  This can be in-place.
+		template<class InputData, class OutputData>
+		void process(InputData &&input, OutputData &&output, int length) {
+			Sample chunk[chunkLength], sum[chunkLength], interleaved[chunkLength*lanes];
+			for (int start = 0; start < length; start += chunkLength) {
+				int count = std::min(chunkLength, length - start);
+				for (int i = 0; i < count; ++i) {
+					chunk[i] = input[start + i];
+					sum[i] = chunk[i]*direct;
+				}
+				for (int g = 0; g < groups; ++g) {
+					for (int i = 0; i < count; ++i) {
+						for (int l = 0; l < lanes; ++l) interleaved[i*lanes + l] = chunk[i];
+					}
+					biquadLanes(interleaved, count, coeffs.data() + g*lanes*5, state.data() + g*lanes*4);
+					for (int i = 0; i < count; ++i) {
+						const Sample *v = interleaved + i*lanes;
+						sum[i] += ((v[0] + v[1]) + (v[2] + v[3])) + ((v[4] + v[5]) + (v[6] + v[7]));
+					}
+				}
+				for (int i = 0; i < count; ++i) output[start + i] = sum[i];
+			}
+		}
+
+		std::complex<Sample> response(Sample scaledFreq) const {
+			Sample w = scaledFreq*Sample(2*M_PI);
+			std::complex<Sample> invZ = {std::cos(w), -std::sin(w)}, invZ2 = invZ*invZ;
+			std::complex<Sample> result = direct;
+			for (int k = 0; k < sectionCount; ++k) {
+				Coefficients c = section(k);
+				result += (c.b0 + invZ*c.b1 + invZ2*c.b2)/(Sample(1) + invZ*c.a1 + invZ2*c.a2);
+			}
+			return result;
+		}
+		Sample responseDb(Sample scaledFreq) const {
+			return 10*std::log10(std::norm(response(scaledFreq)));
+		}
+	};
+
 	/** @} */
 }} // signalsmith::filters::
 #endif // include guard
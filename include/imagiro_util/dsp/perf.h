@@ -4,6 +4,10 @@
 #define SIGNALSMITH_DSP_PERF_H
 
 #include <complex>
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
 
 #if defined(__SSE__) || defined(_M_X64)
 #	include <xmmintrin.h>
@@ -78,6 +82,45 @@ namespace perf {
 	class StopDenormals {}; // FIXME: add for other architectures
 #endif
 
+	/** @brief Allocator for SIMD-friendly storage, aligned to `alignment` bytes
+		Use with `std::vector`, e.g. `AlignedVector<float>`.
+	*/
+	template<typename T, size_t alignment=64>
+	struct AlignedAllocator {
+		static_assert((alignment&(alignment - 1)) == 0, "alignment must be a power of 2");
+		using value_type = T;
+		template<class U>
+		struct rebind {
+			using other = AlignedAllocator<U, alignment>;
+		};
+
+		AlignedAllocator() {}
+		template<class U>
+		AlignedAllocator(const AlignedAllocator<U, alignment> &) {}
+
+		T * allocate(size_t n) {
+			// Over-allocate, and keep the original pointer just before the aligned block
+			char *raw = (char *)::operator new(n*sizeof(T) + alignment + sizeof(void *));
+			uintptr_t aligned = ((uintptr_t)(raw + sizeof(void *)) + (alignment - 1))&~uintptr_t(alignment - 1);
+			((void **)aligned)[-1] = raw;
+			return (T *)aligned;
+		}
+		void deallocate(T *pointer, size_t) {
+			::operator delete(((void **)pointer)[-1]);
+		}
+
+		template<class U>
+		bool operator ==(const AlignedAllocator<U, alignment> &) const {
+			return true;
+		}
+		template<class U>
+		bool operator !=(const AlignedAllocator<U, alignment> &) const {
+			return false;
+		}
+	};
+	template<typename T>
+	using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
 /** @} */
 }} // signalsmith::perf::
 
@@ -5,6 +5,7 @@
 
 #include "./windows.h"
 #include "./delay.h"
+#include "./fft.h"
 
 namespace signalsmith {
 namespace rates {
@@ -68,6 +69,8 @@ namespace rates {
 
 		\diagram{rates-oversampler2xfir-lengths.svg,Resample error rates for different passband thresholds}
 	
+		This is a polyphase half-band design: the even outputs of the upsampler are just the (delayed) input, so only the odd outputs are filtered, with the half-sample kernel.  The downsampler similarly only filters the odd samples.  The filters run on chunks of output at once, so the inner loops vectorise.
+
 		Since both upsample and downsample are stateful, channels are meaningful.  If your input channel-count doesn't match your output, you can size it to the larger of the two, and use `.upChannel()` and `.downChannel()` to only process the channels which exist.*/
 	template<typename Sample>
 	struct Oversampler2xFIR {
@@ -85,15 +88,21 @@ namespace rates {
 			channels = nChannels;
 			halfSampleKernel.resize(kernelLength);
 			fillKaiserSinc(halfSampleKernel, kernelLength, passFreq, 1 - passFreq);
-			inputStride = kernelLength + maxBlockLength;
+			// Double-length histories, so the end only gets copied back to the start every few blocks
+			inputStride = (kernelLength + maxBlockLength)*2;
 			inputBuffer.resize(channels*inputStride);
-			stride = (maxBlockLength + kernelLength)*2;
+			stride = (maxBlockLength + kernelLength)*4;
 			buffer.resize(stride*channels);
+			inputPositions.resize(channels);
+			bufferPositions.resize(channels);
+			reset();
 		}
 
 		void reset() {
 			inputBuffer.assign(inputBuffer.size(), 0);
 			buffer.assign(buffer.size(), 0);
+			inputPositions.assign(channels, 0);
+			bufferPositions.assign(channels, 0);
 		}
 
 		/// @brief Round-trip latency (or equivalently: upsample latency at the higher rate).
@@ -113,24 +122,21 @@ namespace rates {
 		/// Upsamples a single-channel input into the internal buffer
 		template<class Data>
 		void upChannel(int c, Data &&data, int lowSamples) {
-			Sample *inputChannel = inputBuffer.data() + c*inputStride;
+			Sample *inputChannel = inputBuffer.data() + c*inputStride + inputPositions[c];
 			for (int i = 0; i < lowSamples; ++i) {
 				inputChannel[kernelLength + i] = data[i];
 			}
 			Sample *output = (*this)[c];
-			for (int i = 0; i < lowSamples; ++i) {
-				output[2*i] = inputChannel[i + oneWayLatency];
-				Sample *offsetInput = inputChannel + (i + 1);
-				Sample sum = 0;
-				for (int o = 0; o < kernelLength; ++o) {
-					sum += offsetInput[o]*halfSampleKernel[o];
+			for (int start = 0; start < lowSamples; start += maxChunk) {
+				int count = std::min(lowSamples - start, maxChunk);
+				Sample sums[maxChunk];
+				halfSampleSums(inputChannel + start + 1, 1, sums, count);
+				for (int i = 0; i < count; ++i) {
+					output[2*(start + i)] = inputChannel[start + i + oneWayLatency];
+					output[2*(start + i) + 1] = sums[i];
 				}
-				output[2*i + 1] = sum;
-			}
-			// Copy the end of the buffer back to the beginning
-			for (int i = 0; i < kernelLength; ++i) {
-				inputChannel[i] = inputChannel[lowSamples + i];
 			}
+			advance(inputBuffer.data() + c*inputStride, inputPositions[c], lowSamples, kernelLength, inputStride);
 		}
 
 		/// Downsamples from the internal buffer to a multi-channel output
@@ -144,39 +150,556 @@ namespace rates {
 		/// Downsamples a single channel from the internal buffer to a single-channel output
 		template<class Data>
 		void downChannel(int c, Data &&data, int lowSamples) {
-			Sample *input = buffer.data() + c*stride; // no offset for latency
-			for (int i = 0; i < lowSamples; ++i) {
-				Sample v1 = input[2*i + kernelLength];
-				Sample sum = 0;
-				for (int o = 0; o < kernelLength; ++o) {
-					Sample v2 = input[2*(i + o) + 1];
-					sum += v2*halfSampleKernel[o];
+			Sample *input = buffer.data() + c*stride + bufferPositions[c]; // no offset for latency
+			for (int start = 0; start < lowSamples; start += maxChunk) {
+				int count = std::min(lowSamples - start, maxChunk);
+				Sample sums[maxChunk];
+				halfSampleSums(input + 2*start + 1, 2, sums, count);
+				for (int i = 0; i < count; ++i) {
+					Sample v1 = input[2*(start + i) + kernelLength];
+					Sample v2 = sums[i];
+					data[start + i] = (v1 + v2)*Sample(0.5);
 				}
-				Sample v2 = sum;
-				Sample v = (v1 + v2)*Sample(0.5);
-				data[i] = v;
-			}
-			// Copy the end of the buffer back to the beginning
-			for (int i = 0; i < kernelLength*2; ++i) {
-				input[i] = input[lowSamples*2 + i];
 			}
+			advance(buffer.data() + c*stride, bufferPositions[c], lowSamples*2, kernelLength*2, stride);
 		}
 
 		/// Gets the samples for a single (higher-rate) channel.  The valid length depends how many input samples were passed into `.up()`/`.upChannel()`.
 		Sample * operator[](int c) {
-			return buffer.data() + kernelLength*2 + stride*c;
+			return buffer.data() + stride*c + bufferPositions[c] + kernelLength*2;
 		}
 		const Sample * operator[](int c) const {
-			return buffer.data() + kernelLength*2 + stride*c;
+			return buffer.data() + stride*c + bufferPositions[c] + kernelLength*2;
 		}
 
 	private:
+		static constexpr int maxChunk = 64;
 		int oneWayLatency, kernelLength;
 		int channels;
 		int stride, inputStride;
 		std::vector<Sample> inputBuffer;
 		std::vector<Sample> halfSampleKernel;
 		std::vector<Sample> buffer;
+		std::vector<int> inputPositions, bufferPositions;
+
+		/** Applies the half-sample kernel at `count` consecutive positions, where `input[step*o]` is the input for tap `o`.
+		The loops are ordered tap-first, so the inner loop runs across the outputs (which vectorises without re-ordering any sums). */
+		void halfSampleSums(const Sample *input, int step, Sample *sums, int count) const {
+			for (int i = 0; i < count; ++i) sums[i] = 0;
+			for (int o = 0; o < kernelLength; ++o) {
+				const Sample *offsetInput = input + step*o;
+				Sample k = halfSampleKernel[o];
+				if (step == 1) {
+					for (int i = 0; i < count; ++i) sums[i] += offsetInput[i]*k;
+				} else {
+					for (int i = 0; i < count; ++i) sums[i] += offsetInput[2*i]*k;
+				}
+			}
+		}
+
+		/** Moves a channel's history forward, only copying it back to the start once the buffer runs out.
+		The channel holds twice the history plus the largest block, so there's room for another block until we're past halfway. */
+		static void advance(Sample *channelStart, int &position, int samples, int historyLength, int channelLength) {
+			position += samples;
+			if (position*2 > channelLength) {
+				std::copy(channelStart + position, channelStart + position + historyLength, channelStart);
+				position = 0;
+			}
+		}
+	};
+
+	namespace _rates_impl {
+		/// The squared modulus `k` for an elliptic half-band design with a given transition bandwidth (0 to 0.5, relative to the lower rate)
+		inline double ellipticHalfbandModulus(double transition) {
+			transition = std::max(1e-4, std::min(0.4999, transition));
+			double k = std::tan((1 - 2*transition)*M_PI/4);
+			return k*k;
+		}
+		/// The nome `q` for the same design.  The stopband attenuation depends on `q^order`.
+		inline double ellipticHalfbandNome(double transition) {
+			double k = ellipticHalfbandModulus(transition);
+			double kksqrt = std::pow(1 - k*k, 0.25);
+			double e = 0.5*(1 - kksqrt)/(1 + kksqrt);
+			double e4 = e*e*e*e;
+			return e*(1 + e4*(2 + e4*(15 + 150*e4)));
+		}
+
+		/** Runs a pair of first-order allpass sections (one per branch) along a block, for 8 interleaved channels (`data[i*8 + lane]`).
+		The state is `{x1, y1}` for each section, 8 lanes each. */
+		template<typename Sample>
+		void allpassPairScalar(Sample *even, Sample *odd, int length, Sample coeffEven, Sample coeffOdd, Sample *evenState, Sample *oddState) {
+			for (int l = 0; l < 8; ++l) {
+				Sample x1e = evenState[l], y1e = evenState[8 + l], x1o = oddState[l], y1o = oddState[8 + l];
+				for (int i = 0; i < length; ++i) {
+					Sample xe = even[i*8 + l], xo = odd[i*8 + l];
+					Sample ye = (xe - y1e)*coeffEven + x1e;
+					Sample yo = (xo - y1o)*coeffOdd + x1o;
+					x1e = xe;
+					y1e = ye;
+					x1o = xo;
+					y1o = yo;
+					even[i*8 + l] = ye;
+					odd[i*8 + l] = yo;
+				}
+				evenState[l] = x1e;
+				evenState[8 + l] = y1e;
+				oddState[l] = x1o;
+				oddState[8 + l] = y1o;
+			}
+		}
+
+#if defined(SIGNALSMITH_FFT_SSE2) || defined(SIGNALSMITH_FFT_NEON)
+		// Uses the SIMD packs from the FFT, with one copy per instruction set (as in `fft.h`).  Each lane is a separate recurrence, so this gives the same results as the scalar version.
+#define SIGNALSMITH_RATES_SIMD_ALLPASS(TARGET) \
+		template<class Pack, typename Sample> \
+		TARGET void allpassPair(Sample *even, Sample *odd, int length, Sample coeffEven, Sample coeffOdd, Sample *evenState, Sample *oddState) { \
+			using V = typename Pack::V; \
+			constexpr int width = int(Pack::width*2), packs = 8/width; \
+			Sample coeffs[16]; \
+			for (int l = 0; l < 8; ++l) { \
+				coeffs[l] = coeffEven; \
+				coeffs[8 + l] = coeffOdd; \
+			} \
+			V ce = Pack::loadReals(coeffs), co = Pack::loadReals(coeffs + 8); \
+			V x1e[packs], y1e[packs], x1o[packs], y1o[packs]; \
+			for (int p = 0; p < packs; ++p) { \
+				x1e[p] = Pack::loadReals(evenState + p*width); \
+				y1e[p] = Pack::loadReals(evenState + 8 + p*width); \
+				x1o[p] = Pack::loadReals(oddState + p*width); \
+				y1o[p] = Pack::loadReals(oddState + 8 + p*width); \
+			} \
+			for (int i = 0; i < length; ++i) { \
+				for (int p = 0; p < packs; ++p) { \
+					V xe = Pack::loadReals(even + i*8 + p*width), xo = Pack::loadReals(odd + i*8 + p*width); \
+					y1e[p] = Pack::add(Pack::mul(Pack::sub(xe, y1e[p]), ce), x1e[p]); \
+					y1o[p] = Pack::add(Pack::mul(Pack::sub(xo, y1o[p]), co), x1o[p]); \
+					x1e[p] = xe; \
+					x1o[p] = xo; \
+					Pack::storeReals(even + i*8 + p*width, y1e[p]); \
+					Pack::storeReals(odd + i*8 + p*width, y1o[p]); \
+				} \
+			} \
+			for (int p = 0; p < packs; ++p) { \
+				Pack::storeReals(evenState + p*width, x1e[p]); \
+				Pack::storeReals(evenState + 8 + p*width, y1e[p]); \
+				Pack::storeReals(oddState + p*width, x1o[p]); \
+				Pack::storeReals(oddState + 8 + p*width, y1o[p]); \
+			} \
+		}
+		namespace _simd_native {
+			SIGNALSMITH_RATES_SIMD_ALLPASS()
+		}
+#	ifdef SIGNALSMITH_FFT_AVX2
+		namespace _simd_avx2 {
+			SIGNALSMITH_RATES_SIMD_ALLPASS(SIGNALSMITH_FFT_AVX2)
+		}
+#	endif
+#undef SIGNALSMITH_RATES_SIMD_ALLPASS
+#endif
+
+		template<typename Sample>
+		using AllpassPair = void (*)(Sample *even, Sample *odd, int length, Sample coeffEven, Sample coeffOdd, Sample *evenState, Sample *oddState);
+
+		template<typename Sample>
+		AllpassPair<Sample> chooseAllpassPair(Sample *) {
+			return allpassPairScalar<Sample>;
+		}
+#ifdef SIGNALSMITH_FFT_SSE2
+		inline AllpassPair<float> chooseAllpassPair(float *) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (::signalsmith::fft::_fft_impl::cpuSupportsAvx2()) return _simd_avx2::allpassPair<::signalsmith::fft::_fft_impl::PackAvx2Float, float>;
+#	endif
+			return _simd_native::allpassPair<::signalsmith::fft::_fft_impl::PackSse2Float, float>;
+		}
+		inline AllpassPair<double> chooseAllpassPair(double *) {
+#	ifdef SIGNALSMITH_FFT_AVX2
+			if (::signalsmith::fft::_fft_impl::cpuSupportsAvx2()) return _simd_avx2::allpassPair<::signalsmith::fft::_fft_impl::PackAvx2Double, double>;
+#	endif
+			return _simd_native::allpassPair<::signalsmith::fft::_fft_impl::PackSse2Double, double>;
+		}
+#elif defined(SIGNALSMITH_FFT_NEON)
+		inline AllpassPair<float> chooseAllpassPair(float *) {
+			return _simd_native::allpassPair<::signalsmith::fft::_fft_impl::PackNeonFloat, float>;
+		}
+		inline AllpassPair<double> chooseAllpassPair(double *) {
+			return _simd_native::allpassPair<::signalsmith::fft::_fft_impl::PackNeonDouble, double>;
+		}
+#endif
+	}
+
+	/** 2x IIR oversampling, using a polyphase-allpass half-band filter.
+
+		This has the same interface as `Oversampler2xFIR` (so either can be used as a template parameter, including for `OversamplerMultistage`), but much lower latency, at the cost of a non-linear phase response.
+
+		The half-band filter is split into two branches of first-order allpass sections (running at the lower rate), with their coefficients alternating between branches.  When upsampling, each input sample runs through both branches, which produce the even/odd outputs.  When downsampling, the odd/even samples go through the branches and are averaged.  The coefficients are designed for the transition band between `passFreq` and `1 - passFreq` (relative to the lower rate), using the elliptic-filter approach from Valenzuela & Constantinides, "Digital signal processing schemes for efficient interpolation and decimation" (1983).
+
+		Channels are processed in interleaved groups of 8, using the FFT's SIMD packs across channels, while each allpass section runs along the whole block with its state kept in registers.  Each section is a serial recurrence, so with only one or two channels this can cost more CPU than `Oversampler2xFIR`.
+	*/
+	template<typename Sample>
+	struct Oversampler2xIIR {
+		Oversampler2xIIR() : Oversampler2xIIR(0, 0) {}
+		Oversampler2xIIR(int channels, int maxBlock, int coefficientCount=8, double passFreq=0.43) {
+			resize(channels, maxBlock, coefficientCount, passFreq);
+		}
+
+		void resize(int nChannels, int maxBlockLength) {
+			resize(nChannels, maxBlockLength, int(coefficients.size()), transitionPassFreq);
+		}
+		/// More coefficients (split between the two branches) give a steeper/deeper stopband
+		void resize(int nChannels, int maxBlockLength, int coefficientCount, double passFreq=0.43) {
+			channels = nChannels;
+			maxBlock = std::max(maxBlockLength, 1);
+			transitionPassFreq = passFreq;
+			coefficientCount = std::max(coefficientCount, 1);
+			designCoefficients(coefficientCount, 0.5 - passFreq);
+			groups = (channels + lanes - 1)/lanes;
+			upState.resize(coefficientCount*groups*lanes*2);
+			downState.resize(coefficientCount*groups*lanes*2);
+			evenBranch.resize(maxBlock*lanes);
+			oddBranch.resize(maxBlock*lanes);
+			stride = maxBlock*2;
+			buffer.resize(stride*channels);
+			reset();
+		}
+
+		void reset() {
+			upState.assign(upState.size(), 0);
+			downState.assign(downState.size(), 0);
+			evenBranch.assign(evenBranch.size(), 0);
+			oddBranch.assign(oddBranch.size(), 0);
+			buffer.assign(buffer.size(), 0);
+		}
+
+		/// @brief Round-trip group delay at 0Hz, at the lower rate.
+		/// This varies with frequency, rising towards the transition band.  Unlike `Oversampler2xFIR`, the upsampled signal alone is half a sample later than this (at the higher rate), because the odd branch's extra sample is cancelled by the branch swap in `.down()`.
+		double groupDelay() const {
+			return dcGroupDelay;
+		}
+		/// The round-trip group delay at 0Hz, rounded to the nearest sample
+		int latency() const {
+			return int(std::round(dcGroupDelay));
+		}
+		int coefficientCount() const {
+			return int(coefficients.size());
+		}
+
+		/// Upsamples from a multi-channel input into the internal buffer
+		template<class Data>
+		void up(Data &&data, int lowSamples) {
+			for (int g = 0; g < groups; ++g) {
+				int groupChannels = std::min(lanes, channels - g*lanes);
+				for (int c = 0; c < groupChannels; ++c) {
+					auto &&channel = data[g*lanes + c];
+					for (int i = 0; i < lowSamples; ++i) {
+						evenBranch[i*lanes + c] = oddBranch[i*lanes + c] = channel[i];
+					}
+				}
+				runBranches(lowSamples, upState.data() + g*lanes*2);
+				for (int c = 0; c < groupChannels; ++c) {
+					Sample *output = (*this)[g*lanes + c];
+					for (int i = 0; i < lowSamples; ++i) {
+						output[2*i] = evenBranch[i*lanes + c];
+						output[2*i + 1] = oddBranch[i*lanes + c];
+					}
+				}
+			}
+		}
+		/// Upsamples a single-channel input into the internal buffer
+		template<class Data>
+		void upChannel(int c, Data &&data, int lowSamples) {
+			Sample *output = (*this)[c];
+			for (int i = 0; i < lowSamples; ++i) {
+				output[2*i] = output[2*i + 1] = data[i];
+			}
+			runBranchesSingle(output, lowSamples, upState.data() + (c/lanes)*lanes*2 + c%lanes);
+		}
+
+		/// Downsamples from the internal buffer to a multi-channel output
+		template<class Data>
+		void down(Data &&data, int lowSamples) {
+			for (int g = 0; g < groups; ++g) {
+				int groupChannels = std::min(lanes, channels - g*lanes);
+				// The branches are swapped relative to `.up()`, which lines them back up
+				for (int c = 0; c < groupChannels; ++c) {
+					const Sample *input = (*this)[g*lanes + c];
+					for (int i = 0; i < lowSamples; ++i) {
+						evenBranch[i*lanes + c] = input[2*i + 1];
+						oddBranch[i*lanes + c] = input[2*i];
+					}
+				}
+				runBranches(lowSamples, downState.data() + g*lanes*2);
+				for (int c = 0; c < groupChannels; ++c) {
+					auto &&channel = data[g*lanes + c];
+					for (int i = 0; i < lowSamples; ++i) {
+						channel[i] = (evenBranch[i*lanes + c] + oddBranch[i*lanes + c])*Sample(0.5);
+					}
+				}
+			}
+		}
+		/// Downsamples a single channel from the internal buffer to a single-channel output
+		template<class Data>
+		void downChannel(int c, Data &&data, int lowSamples) {
+			Sample *input = (*this)[c];
+			// Swap each pair in place, so the branches line up (see `.down()`)
+			for (int i = 0; i < lowSamples; ++i) {
+				std::swap(input[2*i], input[2*i + 1]);
+			}
+			runBranchesSingle(input, lowSamples, downState.data() + (c/lanes)*lanes*2 + c%lanes);
+			for (int i = 0; i < lowSamples; ++i) {
+				data[i] = (input[2*i] + input[2*i + 1])*Sample(0.5);
+			}
+		}
+
+		/// Gets the samples for a single (higher-rate) channel.  The valid length depends how many input samples were passed into `.up()`/`.upChannel()`.
+		Sample * operator[](int c) {
+			return buffer.data() + stride*c;
+		}
+		const Sample * operator[](int c) const {
+			return buffer.data() + stride*c;
+		}
+
+	private:
+		// Channels are processed in groups of this many, interleaved so the inner loops are across channels
+		static constexpr int lanes = 8;
+		int channels = 0, groups = 0, maxBlock = 0, stride = 0;
+		double transitionPassFreq = 0.43, dcGroupDelay = 0;
+		std::vector<Sample> coefficients;
+		// Allpass state, indexed by [coefficient][group], with the previous inputs for each lane and then the previous outputs
+		std::vector<Sample> upState, downState;
+		// One group's branches, indexed by [sample][lane]
+		std::vector<Sample> evenBranch, oddBranch;
+		std::vector<Sample> buffer;
+		_rates_impl::AllpassPair<Sample> allpassPair = _rates_impl::chooseAllpassPair((Sample *)nullptr);
+
+		/** Runs the allpass chains for one group of channels along the block.
+		Each section runs over the whole block (keeping its state in registers), with the two branches' sections paired up so there are two independent recurrences at once. */
+		void runBranches(int length, Sample *state) {
+			const int coefficientCount = int(coefficients.size());
+			const int rowStride = groups*lanes*2;
+			for (int k = 0; k + 1 < coefficientCount; k += 2) {
+				allpassPair(evenBranch.data(), oddBranch.data(), length, coefficients[k], coefficients[k + 1], state + k*rowStride, state + (k + 1)*rowStride);
+			}
+			if (coefficientCount%2) {
+				// Unpaired last section (in the even branch)
+				Sample coefficient = coefficients.back();
+				Sample *x1 = state + (coefficientCount - 1)*rowStride, *y1 = x1 + lanes;
+				for (int i = 0; i < length; ++i) {
+					Sample *branch = evenBranch.data() + i*lanes;
+					for (int l = 0; l < lanes; ++l) {
+						Sample x = branch[l];
+						Sample y = (x - y1[l])*coefficient + x1[l];
+						x1[l] = x;
+						y1[l] = y;
+						branch[l] = y;
+					}
+				}
+			}
+		}
+		/// Runs the allpass chains for a single channel, where the branches are interleaved in `values` (even, odd, even, ...)
+		void runBranchesSingle(Sample *values, int length, Sample *state) {
+			const int coefficientCount = int(coefficients.size());
+			const int rowStride = groups*lanes*2;
+			for (int k = 0; k < coefficientCount; ++k) {
+				Sample coefficient = coefficients[k];
+				Sample x1 = state[k*rowStride], y1 = state[k*rowStride + lanes];
+				Sample *branch = values + (k&1);
+				for (int i = 0; i < length; ++i) {
+					Sample x = branch[2*i];
+					Sample y = (x - y1)*coefficient + x1;
+					x1 = x;
+					y1 = y;
+					branch[2*i] = y;
+				}
+				state[k*rowStride] = x1;
+				state[k*rowStride + lanes] = y1;
+			}
+		}
+
+		// Elliptic half-band design: the allpass coefficients for a given transition bandwidth (0 to 0.5, relative to the lower rate)
+		void designCoefficients(int coefficientCount, double transition) {
+			double k = _rates_impl::ellipticHalfbandModulus(transition);
+			double q = _rates_impl::ellipticHalfbandNome(transition);
+
+			int order = coefficientCount*2 + 1;
+			coefficients.resize(coefficientCount);
+			double branchDelays[2] = {0, 0};
+			for (int index = 0; index < coefficientCount; ++index) {
+				int c = index + 1;
+				double num = 0, den = 0;
+				for (int i = 0, sign = 1; ; ++i, sign = -sign) {
+					double term = std::pow(q, i*(i + 1))*std::sin((2*i + 1)*c*M_PI/order)*sign;
+					num += term;
+					if (std::abs(term) < 1e-100) break;
+				}
+				for (int i = 1, sign = -1; ; ++i, sign = -sign) {
+					double term = std::pow(q, i*i)*std::cos(2*i*c*M_PI/order)*sign;
+					den += term;
+					if (std::abs(term) < 1e-100) break;
+				}
+				num *= std::pow(q, 0.25);
+				den += 0.5;
+				double ww = num/den, wwsq = ww*ww;
+				double x = std::sqrt((1 - wwsq*k)*(1 - wwsq/k))/(1 + wwsq);
+				double coefficient = (1 - x)/(1 + x);
+				coefficients[index] = Sample(coefficient);
+				// Each section delays 0Hz by (1 - c)/(1 + c) lower-rate samples
+				branchDelays[index&1] += (1 - coefficient)/(1 + coefficient);
+			}
+			// Upsampling then downsampling runs each sample through both branches (once each), so the round trip is their total delay
+			dcGroupDelay = branchDelays[0] + branchDelays[1];
+		}
+	};
+
+	/** How `OversamplerMultistage` sets up its 2x stages, and adds up their latencies.
+
+		This default is for stages like `Oversampler2xFIR`, where the parameter is `halfLatency`.  Later stages get a wider transition band, so their kernels are shortened in proportion (keeping the transition bandwidth per tap roughly constant), and rounded so that the total latency is a whole number of samples.  Specialise this for other stage types.
+	*/
+	template<class Stage>
+	struct OversamplerStageTraits {
+		/// Sets up stage `k` (whose lower rate is `2^k` times the original rate), from the first stage's parameter and `passFreq`
+		static void resize(Stage &stage, int k, int channels, int maxBlock, int firstHalfLatency, double firstPassFreq) {
+			int halfLatency = firstHalfLatency;
+			double passFreq = firstPassFreq;
+			if (k > 0) {
+				passFreq = firstPassFreq/(1 << k);
+				halfLatency = int(std::ceil(firstHalfLatency*(1 - 2*firstPassFreq)/(1 - 2*passFreq)));
+				// Stage `k`'s latency is divided by 2^k at the original rate, so keep it a whole number
+				int multiple = 1 << (k - 1);
+				halfLatency = std::max(halfLatency, 2);
+				halfLatency = (halfLatency + multiple - 1)/multiple*multiple;
+			}
+			stage.resize(channels, maxBlock, halfLatency, passFreq);
+		}
+		/// Round-trip delay, at the stage's lower rate
+		static double groupDelay(const Stage &stage) {
+			return stage.latency();
+		}
+	};
+	/// For `Oversampler2xIIR` the parameter is the first stage's `coefficientCount`.  Later stages use the fewest coefficients which match the first stage's stopband attenuation.
+	template<typename Sample>
+	struct OversamplerStageTraits<Oversampler2xIIR<Sample>> {
+		static void resize(Oversampler2xIIR<Sample> &stage, int k, int channels, int maxBlock, int firstCoefficientCount, double firstPassFreq) {
+			int coefficientCount = std::max(firstCoefficientCount, 1);
+			double passFreq = firstPassFreq;
+			if (k > 0) {
+				passFreq = firstPassFreq/(1 << k);
+				// Attenuation depends on `q^order` (where `order = 2*coefficientCount + 1`)
+				double firstLogQ = std::log(_rates_impl::ellipticHalfbandNome(0.5 - firstPassFreq));
+				double logQ = std::log(_rates_impl::ellipticHalfbandNome(0.5 - passFreq));
+				double order = (2*coefficientCount + 1)*firstLogQ/logQ;
+				coefficientCount = std::max(1, int(std::ceil((order - 1)*0.5 - 1e-6)));
+			}
+			stage.resize(channels, maxBlock, coefficientCount, passFreq);
+		}
+		static double groupDelay(const Oversampler2xIIR<Sample> &stage) {
+			return stage.groupDelay();
+		}
+	};
+
+	/** Cascaded 2^N oversampling, from a chain of 2x stages (`Oversampler2xFIR` by default).
+
+		This has the same interface as `Oversampler2xFIR`: `.up()`, then process the higher-rate channels from `oversampler[c]`, then `.down()`.  Each stage upsamples from the previous stage's buffer, and downsamples back into it.
+
+		Only the first stage needs a narrow transition band.  After that the signal only occupies the bottom of the band, so each later stage can use a wider transition band (scaling `passFreq` down by 2 each time), which means a shorter kernel (or fewer allpass coefficients for `Oversampler2xIIR`).  How each stage is set up from the first stage's parameters is chosen by `OversamplerStageTraits<Stage>`.
+
+		The `Stage` type needs `.reset()`, `.up()`/`.down()` and `operator[]`, as well as whatever its `OversamplerStageTraits` uses (by default: `.resize(channels, maxBlock, halfLatency, passFreq)` and `.latency()`, its round-trip latency at its lower rate).
+	*/
+	template<typename Sample, class Stage=Oversampler2xFIR<Sample>>
+	struct OversamplerMultistage {
+		OversamplerMultistage() : OversamplerMultistage(0, 0) {}
+		OversamplerMultistage(int channels, int maxBlock, int stageCount=2, int halfLatency=16, double passFreq=0.43) {
+			resize(channels, maxBlock, stageCount, halfLatency, passFreq);
+		}
+
+		/// Sets up `stageCount` stages (for `2^stageCount` oversampling), where `halfLatency` (or `coefficientCount` for `Oversampler2xIIR`) and `passFreq` are for the first stage
+		void resize(int nChannels, int maxBlockLength, int stageCount, int halfLatency=16, double passFreq=0.43) {
+			stageCount = std::max(stageCount, 1);
+			stages.resize(stageCount);
+			totalDelay = 0;
+			for (int k = 0; k < stageCount; ++k) {
+				Traits::resize(stages[k], k, nChannels, maxBlockLength << k, halfLatency, passFreq);
+				totalDelay += Traits::groupDelay(stages[k])/(1 << k);
+			}
+		}
+
+		void reset() {
+			for (auto &stage : stages) stage.reset();
+		}
+
+		/// Oversampling ratio (`2^stageCount`)
+		int factor() const {
+			return 1 << int(stages.size());
+		}
+		/// Round-trip group delay at 0Hz, at the original (lower) rate
+		double groupDelay() const {
+			return totalDelay;
+		}
+		/// Round-trip latency, rounded to the nearest sample (exact for `Oversampler2xFIR` stages)
+		int latency() const {
+			return int(std::round(totalDelay));
+		}
+
+		/// Upsamples from a multi-channel input into the internal buffer
+		template<class Data>
+		void up(Data &&data, int lowSamples) {
+			stages[0].up(data, lowSamples);
+			for (size_t k = 1; k < stages.size(); ++k) {
+				stages[k].up(StageChannels{stages[k - 1]}, lowSamples << k);
+			}
+		}
+		/// Upsamples a single-channel input into the internal buffer
+		template<class Data>
+		void upChannel(int c, Data &&data, int lowSamples) {
+			stages[0].upChannel(c, data, lowSamples);
+			for (size_t k = 1; k < stages.size(); ++k) {
+				stages[k].upChannel(c, stages[k - 1][c], lowSamples << k);
+			}
+		}
+
+		/// Downsamples from the internal buffer to a multi-channel output
+		template<class Data>
+		void down(Data &&data, int lowSamples) {
+			for (size_t k = stages.size() - 1; k > 0; --k) {
+				stages[k].down(StageChannels{stages[k - 1]}, lowSamples << k);
+			}
+			stages[0].down(data, lowSamples);
+		}
+		/// Downsamples a single channel from the internal buffer to a single-channel output
+		template<class Data>
+		void downChannel(int c, Data &&data, int lowSamples) {
+			for (size_t k = stages.size() - 1; k > 0; --k) {
+				stages[k].downChannel(c, stages[k - 1][c], lowSamples << k);
+			}
+			stages[0].downChannel(c, data, lowSamples);
+		}
+
+		/// Gets the samples for a single channel, at the highest rate (`.factor()` samples for each input sample)
+		Sample * operator[](int c) {
+			return stages.back()[c];
+		}
+		const Sample * operator[](int c) const {
+			return stages.back()[c];
+		}
+
+		/// The individual 2x stages, from the lowest rate up
+		Stage & stage(int k) {
+			return stages[k];
+		}
+		int stageCount() const {
+			return int(stages.size());
+		}
+	private:
+		using Traits = OversamplerStageTraits<Stage>;
+		double totalDelay = 0;
+		std::vector<Stage> stages;
+
+		// A stage's buffer, as multi-channel input/output for the next stage
+		struct StageChannels {
+			Stage &stage;
+			Sample * operator[](int c) const {
+				return stage[c];
+			}
+		};
 	};
 
 /** @} */
@@ -31,8 +31,9 @@ namespace spectral {
 		using Complex = std::complex<Sample>;
 		MRFFT mrfft{2};
 
+		// The windowing loops only use unaligned loads, so the window stays a `std::vector` (as returned by `.window()`)
 		std::vector<Sample> fftWindow;
-		std::vector<Sample> timeBuffer;
+		signalsmith::perf::AlignedVector<Sample> timeBuffer;
 		int offsetSamples = 0;
 	public:
 		/// Returns a fast FFT size <= `size`
@@ -92,44 +93,178 @@ namespace spectral {
 		/// Performs an FFT (with windowing)
 		template<class Input, class Output>
 		void fft(Input &&input, Output &&output) {
-			int fftSize = size();
-			for (int i = 0; i < offsetSamples; ++i) {
-				// Inverted polarity since we're using the MRFFT
-				timeBuffer[i + fftSize - offsetSamples] = -input[i]*fftWindow[i];
-			}
-			for (int i = offsetSamples; i < fftSize; ++i) {
-				timeBuffer[i - offsetSamples] = input[i]*fftWindow[i];
-			}
-			mrfft.fft(timeBuffer, output);
+			windowInput(input);
+			mrfft.fft(timeBuffer.data(), output);
+		}
+		/// Performs an FFT (with windowing), into separate real/imaginary arrays
+		template<class Input>
+		void fft(Input &&input, Sample *outputReal, Sample *outputImag) {
+			windowInput(input);
+			mrfft.fft(timeBuffer.data(), outputReal, outputImag);
 		}
 		/// Performs an FFT (no windowing or rotation)
 		template<class Input, class Output>
 		void fftRaw(Input &&input, Output &&output) {
 			mrfft.fft(input, output);
 		}
+		template<class Input>
+		void fftRaw(Input &&input, Sample *outputReal, Sample *outputImag) {
+			int fftSize = size();
+			for (int i = 0; i < fftSize; ++i) {
+				timeBuffer[i] = input[i];
+			}
+			mrfft.fft(timeBuffer.data(), outputReal, outputImag);
+		}
 
 		/// Inverse FFT, with windowing and 1/N scaling
 		template<class Input, class Output>
 		void ifft(Input &&input, Output &&output) {
-			mrfft.ifft(input, timeBuffer);
-			int fftSize = mrfft.size();
-			Sample norm = 1/(Sample)fftSize;
-
-			for (int i = 0; i < offsetSamples; ++i) {
-				// Inverted polarity since we're using the MRFFT
-				output[i] = -timeBuffer[i + fftSize - offsetSamples]*norm*fftWindow[i];
-			}
-			for (int i = offsetSamples; i < fftSize; ++i) {
-				output[i] = timeBuffer[i - offsetSamples]*norm*fftWindow[i];
-			}
+			mrfft.ifft(input, timeBuffer.data());
+			windowOutput(output);
+		}
+		/// Inverse FFT from separate real/imaginary arrays, with windowing and 1/N scaling
+		template<class Output>
+		void ifft(const Sample *inputReal, const Sample *inputImag, Output &&output) {
+			mrfft.ifft(inputReal, inputImag, timeBuffer.data());
+			windowOutput(output);
 		}
 		/// Performs an IFFT (no windowing or rotation)
 		template<class Input, class Output>
 		void ifftRaw(Input &&input, Output &&output) {
 			mrfft.ifft(input, output);
 		}
+		template<class Output>
+		void ifftRaw(const Sample *inputReal, const Sample *inputImag, Output &&output) {
+			mrfft.ifft(inputReal, inputImag, timeBuffer.data());
+			int fftSize = size();
+			for (int i = 0; i < fftSize; ++i) {
+				output[i] = timeBuffer[i];
+			}
+		}
+
+		/** @name Batched (multi-channel)
+		These window/unwindow each channel as above, but the FFTs for all channels share one pass through the plan.  The time-domain data can be any type where `data[channel][index]` returns samples, and spectra are `channels` blocks of `size()/2` bins, `stride` apart.
+		@{ */
+		/// Allocates the working space for up to `channels`, so the batched methods don't allocate
+		void reserveBatch(int channels) {
+			if ((int)batchTimeBuffer.size() < channels*size()) batchTimeBuffer.resize(channels*size());
+			mrfft.reserveBatch(channels);
+		}
+		/// Batched FFT (with windowing)
+		template<class Input>
+		void fftBatch(Input &&input, Complex *output, int channels, int outputStride) {
+			reserveBatch(channels);
+			int fftSize = size();
+			for (int c = 0; c < channels; ++c) {
+				windowInput(input[c], batchTimeBuffer.data() + c*fftSize);
+			}
+			mrfft.fftBatch(batchTimeBuffer.data(), output, channels, fftSize, outputStride);
+		}
+		/// Batched inverse FFT, with windowing and 1/N scaling
+		template<class Output>
+		void ifftBatch(const Complex *input, Output &&output, int channels, int inputStride) {
+			reserveBatch(channels);
+			int fftSize = size();
+			mrfft.ifftBatch(input, batchTimeBuffer.data(), channels, inputStride, fftSize);
+			for (int c = 0; c < channels; ++c) {
+				windowOutput(output[c], batchTimeBuffer.data() + c*fftSize);
+			}
+		}
+		/// @}
+
+	private:
+		signalsmith::perf::AlignedVector<Sample> batchTimeBuffer;
+
+		/* Finds a contiguous run of `data[index]` onwards, shortening `length` if needed.  This works for pointers, `std::vector`s, and `delay::Buffer` views (which wrap around), and returns `nullptr` for anything else.
+		The windowing loops below only use this to avoid generic indexing, so they vectorise. */
+		template<typename S, class Data>
+		static auto contiguousSpan(Data &&data, int index, int &length, int) -> decltype(data.contiguousLength(), (S *)nullptr) {
+			auto view = data + index;
+			length = std::min(length, view.contiguousLength());
+			return view.data();
+		}
+		template<typename S, class Data>
+		static S * contiguousSpan(Data &&data, int index, int &, long) {
+			using GetIterator = signalsmith::fft::_fft_impl::GetIterator<typename std::decay<Data>::type>;
+			using Iterator = decltype(GetIterator::get(data));
+			S *pointer = signalsmith::fft::_fft_impl::ContiguousPointer<S, Iterator>::get(GetIterator::get(data));
+			return pointer ? pointer + index : nullptr;
+		}
+
+		// Sets `windowed[i - start] = input[i]*window[i]` (negated if `invert`) for `i` in `[start, end)`
+		template<bool invert, class Input>
+		void windowRange(Input &&input, int start, int end, Sample *windowed) const {
+			const Sample *windowPtr = fftWindow.data();
+			int i = start;
+			while (i < end) {
+				int length = end - i;
+				const Sample *inputPtr = contiguousSpan<const Sample>(input, i, length, 0);
+				if (!inputPtr) break;
+				Sample *outputPtr = windowed + (i - start);
+				for (int j = 0; j < length; ++j) {
+					outputPtr[j] = invert ? -inputPtr[j]*windowPtr[i + j] : inputPtr[j]*windowPtr[i + j];
+				}
+				i += length;
+			}
+			for (; i < end; ++i) {
+				windowed[i - start] = invert ? -input[i]*windowPtr[i] : input[i]*windowPtr[i];
+			}
+		}
+		// Sets `output[i] = unwindowed[i - start]*norm*window[i]` (negated if `invert`) for `i` in `[start, end)`
+		template<bool invert, class Output>
+		void unwindowRange(Output &&output, int start, int end, const Sample *unwindowed, Sample norm) const {
+			const Sample *windowPtr = fftWindow.data();
+			int i = start;
+			while (i < end) {
+				int length = end - i;
+				Sample *outputPtr = contiguousSpan<Sample>(output, i, length, 0);
+				if (!outputPtr) break;
+				const Sample *inputPtr = unwindowed + (i - start);
+				for (int j = 0; j < length; ++j) {
+					outputPtr[j] = invert ? -inputPtr[j]*norm*windowPtr[i + j] : inputPtr[j]*norm*windowPtr[i + j];
+				}
+				i += length;
+			}
+			for (; i < end; ++i) {
+				output[i] = invert ? -unwindowed[i - start]*norm*windowPtr[i] : unwindowed[i - start]*norm*windowPtr[i];
+			}
+		}
+
+		template<class Input>
+		void windowInput(Input &&input) {
+			windowInput(input, timeBuffer.data());
+		}
+		template<class Input>
+		void windowInput(Input &&input, Sample *windowed) {
+			int fftSize = size();
+			// Inverted polarity since we're using the MRFFT
+			windowRange<true>(input, 0, offsetSamples, windowed + fftSize - offsetSamples);
+			windowRange<false>(input, offsetSamples, fftSize, windowed);
+		}
+		template<class Output>
+		void windowOutput(Output &&output) {
+			windowOutput(output, timeBuffer.data());
+		}
+		template<class Output>
+		void windowOutput(Output &&output, const Sample *unwindowed) {
+			int fftSize = mrfft.size();
+			Sample norm = 1/(Sample)fftSize;
+
+			// Inverted polarity since we're using the MRFFT
+			unwindowRange<true>(output, 0, offsetSamples, unwindowed + fftSize - offsetSamples, norm);
+			unwindowRange<false>(output, offsetSamples, fftSize, unwindowed, norm);
+		}
 	};
 	
+	/** @brief Interface for running independent tasks in parallel (e.g. on a thread pool)
+		`.run()` must call `task(context, index)` exactly once for each `index` in `[0, count)`, and only return once they have all finished.  The tasks never touch the same data, so they can run in any order.
+	*/
+	struct Executor {
+		using Task = void (*)(void *context, int index);
+		virtual ~Executor() {}
+		virtual void run(int count, Task task, void *context) = 0;
+	};
+
 	/** STFT synthesis, built on a `MultiBuffer`.
  
 		Any window length and block interval is supported, but the FFT size may be rounded up to a faster size (by zero-padding).  It uses a heuristically-optimal Kaiser window modified for perfect-reconstruction.
@@ -204,7 +339,126 @@ namespace spectral {
 				return buffer.data() + channel*stride;
 			}
 		};
-		std::vector<Sample> timeBuffer;
+		/// Like `MultiSpectrum`, but with separate real/imaginary arrays for each channel
+		class MultiSplitSpectrum {
+			int channels, stride;
+			std::vector<Sample> realBuffer, imagBuffer;
+		public:
+			MultiSplitSpectrum() : MultiSplitSpectrum(0, 0) {}
+			MultiSplitSpectrum(int channels, int bands) : channels(channels), stride(bands), realBuffer(channels*bands, 0), imagBuffer(channels*bands, 0) {}
+			
+			void resize(int nChannels, int nBands) {
+				channels = nChannels;
+				stride = nBands;
+				realBuffer.assign(channels*stride, 0);
+				imagBuffer.assign(channels*stride, 0);
+			}
+			
+			void reset() {
+				realBuffer.assign(realBuffer.size(), 0);
+				imagBuffer.assign(imagBuffer.size(), 0);
+			}
+			
+			void swap(MultiSplitSpectrum &other) {
+				using std::swap;
+				swap(realBuffer, other.realBuffer);
+				swap(imagBuffer, other.imagBuffer);
+			}
+
+			Sample * real(int channel) {
+				return realBuffer.data() + channel*stride;
+			}
+			const Sample * real(int channel) const {
+				return realBuffer.data() + channel*stride;
+			}
+			Sample * imag(int channel) {
+				return imagBuffer.data() + channel*stride;
+			}
+			const Sample * imag(int channel) const {
+				return imagBuffer.data() + channel*stride;
+			}
+		};
+		bool useSplitSpectrum = false;
+		// If set, each channel is analysed/synthesised as a separate task, using its own FFT
+		Executor *executor = nullptr;
+		std::vector<WindowedFFT<Sample>> channelFfts;
+		void updateChannelFfts() {
+			if (executor) {
+				channelFfts.assign(channels, fft);
+			} else {
+				channelFfts.clear();
+			}
+		}
+
+		template<class Data>
+		struct AnalyseTask {
+			STFT &stft;
+			Data &data;
+
+			static void run(void *context, int c) {
+				AnalyseTask &task = *(AnalyseTask *)context;
+				task.stft.analyseWith(task.stft.channelFfts[c], c, task.data[c]);
+			}
+		};
+		template<class Data>
+		void analyseWith(WindowedFFT<Sample> &channelFft, int c, Data &&data) {
+			if (useSplitSpectrum) {
+				channelFft.fft(data, splitSpectrum.real(c), splitSpectrum.imag(c));
+			} else {
+				channelFft.fft(data, spectrum[c]);
+			}
+		}
+		struct SynthesiseTask {
+			STFT &stft;
+			int blockIndex;
+
+			static void run(void *context, int c) {
+				SynthesiseTask &task = *(SynthesiseTask *)context;
+				STFT &stft = task.stft;
+				Sample *block = stft.timeBuffer.data() + c*stft._fftSize;
+				if (stft.useSplitSpectrum) {
+					stft.channelFfts[c].ifft(stft.splitSpectrum.real(c), stft.splitSpectrum.imag(c), block);
+				} else {
+					stft.channelFfts[c].ifft(stft.spectrum[c], block);
+				}
+				stft.addBlock(task.blockIndex, c, block);
+			}
+		};
+		void addBlock(int blockIndex, int c, const Sample *block) {
+			auto channel = this->view(blockIndex)[c];
+
+			// Clear out the future sum, a window-length and an interval ahead
+			forEachSpan(channel, _windowSize, _windowSize + _interval, [&](Sample *output, int, int length) {
+				std::fill(output, output + length, Sample(0));
+			});
+
+			// Add in the IFFT'd result
+			forEachSpan(channel, 0, _windowSize, [&](Sample *output, int start, int length) {
+				const Sample *input = block + start;
+				for (int i = 0; i < length; ++i) {
+					output[i] += input[i];
+				}
+			});
+		}
+		// Calls `fn(pointer, start, length)` for contiguous sections of `[start, end)`, splitting where the buffer wraps around
+		template<class Channel, class Fn>
+		static void forEachSpan(Channel channel, int start, int end, Fn &&fn) {
+			while (start < end) {
+				auto view = channel + start;
+				int length = std::min(end - start, view.contiguousLength());
+				fn(view.data(), start, length);
+				start += length;
+			}
+		}
+		// One FFT-length block per channel
+		signalsmith::perf::AlignedVector<Sample> timeBuffer;
+		struct TimeBlocks {
+			Sample *data;
+			int stride;
+			Sample * operator[](int channel) const {
+				return data + channel*stride;
+			}
+		};
 
 		void resizeInternal(int newChannels, int windowSize, int newInterval, int historyLength, int zeroPadding) {
 			Super::resize(newChannels,
@@ -222,8 +476,15 @@ namespace spectral {
 			
 			setWindow(windowShape);
 
-			spectrum.resize(channels, fftSize/2);
-			timeBuffer.resize(fftSize);
+			if (useSplitSpectrum) {
+				spectrum.resize(0, 0);
+				splitSpectrum.resize(channels, fftSize/2);
+			} else {
+				spectrum.resize(channels, fftSize/2);
+				splitSpectrum.resize(0, 0);
+			}
+			timeBuffer.resize(fftSize*channels);
+			fft.reserveBatch(channels);
 		}
 	public:
 		enum class Window {kaiser, acg};
@@ -260,10 +521,15 @@ namespace spectral {
 			for (int i = _windowSize; i < _fftSize; ++i) {
 				window[i] = 0;
 			}
+			updateChannelFfts();
 		}
 		
 		using Spectrum = MultiSpectrum;
 		Spectrum spectrum;
+		using SplitSpectrum = MultiSplitSpectrum;
+		/// Only used (instead of `.spectrum`) if enabled with `.setSplitSpectrum()`
+		SplitSpectrum splitSpectrum;
+		/// If an executor is set, changes to this (e.g. a custom window) are only picked up by the next `.setWindow()` or `.setExecutor()` call
 		WindowedFFT<Sample> fft;
 		
 		STFT() {}
@@ -277,6 +543,32 @@ namespace spectral {
 			resizeInternal(nChannels, windowSize, interval, historyLength, zeroPadding);
 		}
 		
+		/** Stores spectra as separate real/imaginary arrays in `.splitSpectrum`, instead of `.spectrum`.
+		Analysis and synthesis then use the split-complex FFT, which never re-interleaves the data.  This clears the spectrum. */
+		void setSplitSpectrum(bool split) {
+			useSplitSpectrum = split;
+			if (useSplitSpectrum) {
+				spectrum.resize(0, 0);
+				splitSpectrum.resize(channels, _fftSize/2);
+			} else {
+				spectrum.resize(channels, _fftSize/2);
+				splitSpectrum.resize(0, 0);
+			}
+		}
+		bool isSplitSpectrum() const {
+			return useSplitSpectrum;
+		}
+
+		/** Runs the per-channel analysis/synthesis as parallel tasks (or serially again, for `nullptr`).
+		Each channel gets its own copy of `.fft`, and the results are identical to the serial path.  These copies are made here (and in `.setWindow()`), so don't modify `.fft` afterwards without calling this again.  The executor must outlive this STFT (or be removed first). */
+		void setExecutor(Executor *newExecutor) {
+			executor = newExecutor;
+			updateChannelFfts();
+		}
+		Executor * getExecutor() const {
+			return executor;
+		}
+		
 		int windowSize() const {
 			return _windowSize;
 		}
@@ -308,6 +600,7 @@ namespace spectral {
 		void reset() {
 			Super::reset();
 			spectrum.reset();
+			splitSpectrum.reset();
 			validUntilIndex = -1;
 		}
 		
@@ -323,19 +616,22 @@ namespace spectral {
 				int blockIndex = validUntilIndex + 1;
 				fn(blockIndex);
 
-				auto output = this->view(blockIndex);
-				for (int c = 0; c < channels; ++c) {
-					auto channel = output[c];
-
-					// Clear out the future sum, a window-length and an interval ahead
-					for (int wi = _windowSize; wi < _windowSize + _interval; ++wi) {
-						channel[wi] = 0;
+				if (executor) {
+					SynthesiseTask task{*this, blockIndex};
+					executor->run(channels, SynthesiseTask::run, &task);
+				} else {
+					// All channels share one pass through the FFT plan
+					TimeBlocks blocks{timeBuffer.data(), _fftSize};
+					if (useSplitSpectrum) {
+						for (int c = 0; c < channels; ++c) {
+							fft.ifft(splitSpectrum.real(c), splitSpectrum.imag(c), blocks[c]);
+						}
+					} else {
+						fft.ifftBatch(spectrum[0], blocks, channels, bands());
 					}
 
-					// Add in the IFFT'd result
-					fft.ifft(spectrum[c], timeBuffer);
-					for (int wi = 0; wi < _windowSize; ++wi) {
-						channel[wi] += timeBuffer[wi];
+					for (int c = 0; c < channels; ++c) {
+						addBlock(blockIndex, c, blocks[c]);
 					}
 				}
 				validUntilIndex += _interval;
@@ -356,24 +652,40 @@ namespace spectral {
 		Results can be read/edited using `.spectrum`. */
 		template<class Data>
 		void analyse(Data &&data) {
-			for (int c = 0; c < channels; ++c) {
-				fft.fft(data[c], spectrum[c]);
+			if (executor) {
+				AnalyseTask<Data> task{*this, data};
+				executor->run(channels, AnalyseTask<Data>::run, &task);
+			} else if (useSplitSpectrum) {
+				for (int c = 0; c < channels; ++c) {
+					analyse(c, data[c]);
+				}
+			} else {
+				// All channels share one pass through the FFT plan
+				fft.fftBatch(data, spectrum[0], channels, bands());
 			}
 		}
 		template<class Data>
 		void analyse(int c, Data &&data) {
-			fft.fft(data, spectrum[c]);
+			if (useSplitSpectrum) {
+				fft.fft(data, splitSpectrum.real(c), splitSpectrum.imag(c));
+			} else {
+				fft.fft(data, spectrum[c]);
+			}
 		}
 		/// Analyse without windowing or zero-rotation
 		template<class Data>
 		void analyseRaw(Data &&data) {
 			for (int c = 0; c < channels; ++c) {
-				fft.fftRaw(data[c], spectrum[c]);
+				analyseRaw(c, data[c]);
 			}
 		}
 		template<class Data>
 		void analyseRaw(int c, Data &&data) {
-			fft.fftRaw(data, spectrum[c]);
+			if (useSplitSpectrum) {
+				fft.fftRaw(data, splitSpectrum.real(c), splitSpectrum.imag(c));
+			} else {
+				fft.fftRaw(data, spectrum[c]);
+			}
 		}
 
 		int bands() const {
@@ -0,0 +1,112 @@
+#include "dsp/delay.h"
+#include "../test-common.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace signalsmith::delay;
+
+template<class Sample>
+bool close(Sample a, Sample b) {
+	return std::abs(a - b) <= (sizeof(Sample) == 4 ? 1e-5 : 1e-12)*(1 + std::abs(b));
+}
+
+// Block writes/reads (per-sample delays, a constant delay, and several taps) against per-sample `.write()`/`.read()`
+template<class Sample, template<typename> class Interpolator>
+void testBlocks(const char *name, bool mirrored) {
+	const int maxBlock = 256, maxDelay = 300;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<Sample> signal(-1, 1), delay(0, maxDelay);
+	Delay<Sample, Interpolator> perSample(maxDelay + maxBlock), block(maxDelay + maxBlock);
+	block.setMirrored(mirrored);
+
+	std::vector<Sample> input(maxBlock), delays(maxBlock), delays2(maxBlock);
+	std::vector<Sample> expected(maxBlock), expected2(maxBlock), expectedConstant(maxBlock);
+	std::vector<Sample> output(maxBlock), output2(maxBlock), constantOutput(maxBlock);
+	int mismatches = 0;
+	for (int b = 0; b < 200; ++b) {
+		int length = 1 + int(random()%maxBlock);
+		Sample constantDelay = delay(random);
+		for (int i = 0; i < length; ++i) {
+			input[i] = signal(random);
+			delays[i] = delay(random);
+			delays2[i] = delay(random);
+		}
+		for (int i = 0; i < length; ++i) {
+			perSample.write(input[i]);
+			expected[i] = perSample.read(delays[i]);
+			expected2[i] = perSample.read(delays2[i]);
+			expectedConstant[i] = perSample.read(constantDelay);
+		}
+
+		block.writeBlock(input, length);
+		const Sample *tapDelays[2] = {delays.data(), delays2.data()};
+		Sample *tapOutputs[2] = {output.data(), output2.data()};
+		block.readBlock(tapDelays, tapOutputs, 2, length);
+		for (int i = 0; i < length; ++i) {
+			mismatches += !close(output[i], expected[i]);
+			mismatches += !close(output2[i], expected2[i]);
+		}
+		block.readBlock(constantDelay, constantOutput.data(), length);
+		for (int i = 0; i < length; ++i) mismatches += !close(constantOutput[i], expectedConstant[i]);
+	}
+
+	char message[128];
+	std::snprintf(message, sizeof(message), "Delay<%s>%s: %d block/per-sample mismatches", name, mirrored ? " (mirrored)" : "", mismatches);
+	test::check(mismatches == 0, message);
+}
+
+template<class Sample, template<typename> class Interpolator>
+void benchmark(const char *name) {
+	const int blockLength = 256, maxDelay = 300;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<Sample> signal(-1, 1), delay(0, maxDelay);
+	Delay<Sample, Interpolator> perSample(maxDelay + blockLength), block(maxDelay + blockLength);
+	std::vector<Sample> input(blockLength), delays(blockLength), output(blockLength);
+	for (int i = 0; i < blockLength; ++i) {
+		input[i] = signal(random);
+		delays[i] = delay(random);
+	}
+
+	double blockNs = test::nsPer([&]() {
+		block.writeBlock(input, blockLength);
+		block.readBlock(delays.data(), output.data(), blockLength);
+	}, 4000, blockLength);
+	double perSampleNs = test::nsPer([&]() {
+		for (int i = 0; i < blockLength; ++i) {
+			perSample.write(input[i]);
+			output[i] = perSample.read(delays[i]);
+		}
+	}, 4000, blockLength);
+	std::printf("\t%s: block %.2f, per-sample %.2f\n", name, blockNs, perSampleNs);
+}
+
+template<class Sample> using KaiserSinc8 = InterpolatorKaiserSinc8<Sample>;
+template<class Sample> using KaiserSinc20 = InterpolatorKaiserSinc20<Sample>;
+template<class Sample> using Lagrange7 = InterpolatorLagrange7<Sample>;
+
+int main(int argc, char **argv) {
+	for (bool mirrored : {false, true}) {
+		testBlocks<float, InterpolatorNearest>("float, nearest", mirrored);
+		testBlocks<float, InterpolatorLinear>("float, linear", mirrored);
+		testBlocks<double, InterpolatorLinear>("double, linear", mirrored);
+		testBlocks<float, InterpolatorCubic>("float, cubic", mirrored);
+		testBlocks<double, InterpolatorCubic>("double, cubic", mirrored);
+		testBlocks<float, Lagrange7>("float, Lagrange7", mirrored);
+		testBlocks<float, KaiserSinc8>("float, KaiserSinc8", mirrored);
+		testBlocks<float, KaiserSinc20>("float, KaiserSinc20", mirrored);
+		testBlocks<double, KaiserSinc20>("double, KaiserSinc20", mirrored);
+	}
+
+	if (test::benchMode(argc, argv)) {
+		std::printf("Delay reads: ns per sample\n");
+		benchmark<float, InterpolatorLinear>("float, linear");
+		benchmark<float, InterpolatorCubic>("float, cubic");
+		benchmark<float, Lagrange7>("float, Lagrange7");
+		benchmark<float, KaiserSinc8>("float, KaiserSinc8");
+		benchmark<float, KaiserSinc20>("float, KaiserSinc20");
+		benchmark<double, KaiserSinc20>("double, KaiserSinc20");
+	}
+	return test::finish("dsp/delay");
+}
@@ -0,0 +1,143 @@
+#include "dsp/fft.h"
+#include "../test-common.h"
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Not contiguous as far as the FFT can tell, so results written through this go through the scalar (non-SIMD) path
+template<typename V>
+struct ScalarIterator {
+	std::complex<V> *pointer;
+
+	std::complex<V> & operator[](size_t i) const {
+		return pointer[i];
+	}
+	ScalarIterator operator+(size_t i) const {
+		return {pointer + i};
+	}
+	ScalarIterator & operator+=(size_t i) {
+		pointer += i;
+		return *this;
+	}
+	ScalarIterator & operator++() {
+		++pointer;
+		return *this;
+	}
+	std::complex<V> & operator*() const {
+		return *pointer;
+	}
+	bool operator<(const ScalarIterator &other) const {
+		return pointer < other.pointer;
+	}
+};
+
+template<typename V>
+double tolerance(size_t size) {
+	return std::sqrt(double(size))*std::numeric_limits<V>::epsilon()*8*(1 + std::log2(double(size)));
+}
+
+template<typename V>
+std::vector<std::complex<double>> naiveDft(const std::vector<std::complex<V>> &input, bool inverse) {
+	size_t size = input.size();
+	std::vector<std::complex<double>> result(size);
+	for (size_t k = 0; k < size; ++k) {
+		std::complex<double> sum = 0;
+		for (size_t i = 0; i < size; ++i) {
+			double phase = (inverse ? 2 : -2)*M_PI*double((i*k)%size)/size;
+			sum += std::complex<double>(input[i])*std::polar(1.0, phase);
+		}
+		result[k] = sum;
+	}
+	return result;
+}
+
+template<typename V>
+void testComplex(size_t size, bool inverse) {
+	signalsmith::fft::FFT<V> fft(size);
+	std::vector<std::complex<V>> input(size), output(size), scalarOutput(size);
+	std::mt19937 random(size);
+	std::uniform_real_distribution<V> dist(-1, 1);
+	for (auto &x : input) x = {dist(random), dist(random)};
+
+	if (inverse) {
+		fft.ifft(input, output);
+		fft.ifft(input.data(), ScalarIterator<V>{scalarOutput.data()});
+	} else {
+		fft.fft(input, output);
+		fft.fft(input.data(), ScalarIterator<V>{scalarOutput.data()});
+	}
+
+	double dftError = 0, scalarDiff = 0;
+	if (size <= 1024) {
+		auto expected = naiveDft(input, inverse);
+		for (size_t i = 0; i < size; ++i) dftError = std::max(dftError, std::abs(std::complex<double>(output[i]) - expected[i]));
+	}
+	for (size_t i = 0; i < size; ++i) scalarDiff = std::max(scalarDiff, double(std::abs(output[i] - scalarOutput[i])));
+
+	char name[128];
+	std::snprintf(name, sizeof(name), "FFT<%s>(%d) %s: DFT error %g, SIMD/scalar difference %g", sizeof(V) == 4 ? "float" : "double", int(size), inverse ? "ifft" : "fft", dftError, scalarDiff);
+	test::check(dftError <= tolerance<V>(size) && scalarDiff <= tolerance<V>(size), name);
+}
+
+template<typename V>
+void testReal(size_t size) {
+	signalsmith::fft::RealFFT<V> realFft(size);
+	std::vector<V> input(size), roundTrip(size);
+	std::vector<std::complex<V>> complexInput(size), spectrum(size/2);
+	std::mt19937 random(size);
+	std::uniform_real_distribution<V> dist(-1, 1);
+	for (size_t i = 0; i < size; ++i) complexInput[i] = input[i] = dist(random);
+
+	realFft.fft(input, spectrum);
+	auto expected = naiveDft(complexInput, false);
+	// Bin 0 holds the DC and Nyquist values in its real/imaginary parts
+	double error = std::abs(std::complex<double>(spectrum[0]) - std::complex<double>(expected[0].real(), expected[size/2].real()));
+	for (size_t i = 1; i < size/2; ++i) error = std::max(error, std::abs(std::complex<double>(spectrum[i]) - expected[i]));
+
+	realFft.ifft(spectrum, roundTrip);
+	double roundTripError = 0;
+	for (size_t i = 0; i < size; ++i) roundTripError = std::max(roundTripError, std::abs(double(roundTrip[i])/size - input[i]));
+
+	char name[128];
+	std::snprintf(name, sizeof(name), "RealFFT<%s>(%d): DFT error %g, round-trip error %g", sizeof(V) == 4 ? "float" : "double", int(size), error, roundTripError);
+	test::check(error <= tolerance<V>(size) && roundTripError <= tolerance<V>(size), name);
+}
+
+template<typename V>
+void benchmark() {
+	std::printf("FFT<%s>: ns per complex sample\n", sizeof(V) == 4 ? "float" : "double");
+	for (size_t size = 64; size <= 65536; size *= 4) {
+		signalsmith::fft::FFT<V> fft(size);
+		std::vector<std::complex<V>> input(size, V(0.5)), output(size);
+		int repeats = int(std::max<size_t>(20, 4000000/size));
+		double simd = test::nsPer([&]() {
+			fft.fft(input, output);
+		}, repeats, size);
+		double scalar = test::nsPer([&]() {
+			fft.fft(input.data(), ScalarIterator<V>{output.data()});
+		}, repeats, size);
+		std::printf("\t%6d: SIMD %.3f, scalar %.3f\n", int(size), simd, scalar);
+	}
+}
+
+int main(int argc, char **argv) {
+	for (size_t size : {1, 2, 3, 4, 5, 6, 8, 12, 15, 16, 24, 32, 48, 64, 96, 128, 256, 360, 512, 1024, 4096, 65536}) {
+		for (bool inverse : {false, true}) {
+			testComplex<float>(size, inverse);
+			testComplex<double>(size, inverse);
+		}
+	}
+	for (size_t size : {2, 4, 6, 8, 16, 24, 64, 96, 256, 1024}) {
+		testReal<float>(size);
+		testReal<double>(size);
+	}
+
+	if (test::benchMode(argc, argv)) {
+		benchmark<float>();
+		benchmark<double>();
+	}
+	return test::finish("dsp/fft");
+}
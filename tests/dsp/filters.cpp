@@ -0,0 +1,173 @@
+#include "dsp/filters.h"
+#include "../test-common.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace signalsmith::filters;
+
+template<class Sample>
+bool close(Sample a, Sample b) {
+	return std::abs(a - b) <= (sizeof(Sample) == 4 ? 1e-5 : 1e-12)*(1 + std::abs(b));
+}
+
+template<class Sample>
+void design(BiquadStatic<Sample> &biquad, int index) {
+	if (index%3 == 0) {
+		biquad.lowpass(0.01 + index*0.01);
+	} else if (index%3 == 1) {
+		biquad.peakDb(0.02 + index*0.005, 6, 1, BiquadDesign::vicanek);
+	} else {
+		biquad.highShelf(0.1, 2);
+	}
+}
+
+template<class Sample>
+Sample testSignal(int channel, int index) {
+	return Sample(std::sin(index*0.3 + channel) + (index%17 == 0));
+}
+
+// `BiquadBank` (in uneven blocks, and frame-by-frame) against a `BiquadStatic` per channel
+template<class Sample, int channels>
+void testBank(const char *name) {
+	const int length = 500;
+	BiquadBank<Sample, channels> bank, frameBank;
+	std::vector<BiquadStatic<Sample>> reference(channels);
+	for (int c = 0; c < channels; ++c) {
+		design(reference[c], c);
+		bank.set(c, reference[c]);
+		frameBank.set(c, reference[c]);
+	}
+
+	std::vector<std::vector<Sample>> blockData(channels, std::vector<Sample>(length));
+	for (int c = 0; c < channels; ++c) {
+		for (int i = 0; i < length; ++i) blockData[c][i] = testSignal<Sample>(c, i);
+	}
+	int start = 0;
+	for (int blockLength : {1, 63, 64, 65, 130, 177}) {
+		std::vector<Sample *> pointers(channels);
+		for (int c = 0; c < channels; ++c) pointers[c] = blockData[c].data() + start;
+		bank.process(pointers, pointers, blockLength);
+		start += blockLength;
+	}
+
+	int mismatches = 0;
+	std::vector<Sample> frameIn(channels), frameOut(channels);
+	for (int i = 0; i < length; ++i) {
+		for (int c = 0; c < channels; ++c) frameIn[c] = testSignal<Sample>(c, i);
+		frameBank.processFrame(frameIn, frameOut);
+		for (int c = 0; c < channels; ++c) {
+			Sample expected = reference[c](frameIn[c]);
+			mismatches += !close(blockData[c][i], expected);
+			mismatches += !close(frameOut[c], expected);
+		}
+	}
+	double responseError = 0;
+	for (int c = 0; c < channels; ++c) {
+		responseError = std::max(responseError, double(std::abs(bank.response(c, Sample(0.03)) - reference[c].response(Sample(0.03)))));
+	}
+
+	char message[128];
+	std::snprintf(message, sizeof(message), "BiquadBank<%s, %d>: %d mismatches, response error %g", name, channels, mismatches, responseError);
+	test::check(mismatches == 0 && responseError < 1e-5, message);
+}
+
+// `BiquadCascade::process()` against running each sample through every `BiquadStatic` in turn
+template<class Sample>
+void testCascade(const char *name, int sections) {
+	const int length = 700;
+	BiquadCascade<Sample> cascade(sections);
+	std::vector<BiquadStatic<Sample>> reference(sections);
+	for (int k = 0; k < sections; ++k) {
+		design(reference[k], k);
+		design(cascade[k], k);
+	}
+
+	std::vector<Sample> data(length);
+	for (int i = 0; i < length; ++i) data[i] = testSignal<Sample>(0, i);
+	std::vector<Sample> input = data;
+	int start = 0;
+	for (int blockLength : {1, 255, 256, 188}) {
+		cascade.process(data.data() + start, data.data() + start, blockLength);
+		start += blockLength;
+	}
+
+	int mismatches = 0;
+	for (int i = 0; i < length; ++i) {
+		Sample expected = input[i];
+		for (auto &biquad : reference) expected = biquad(expected);
+		mismatches += !close(data[i], expected);
+	}
+
+	char message[128];
+	std::snprintf(message, sizeof(message), "BiquadCascade<%s> (%d sections): %d mismatches", name, sections, mismatches);
+	test::check(mismatches == 0, message);
+}
+
+template<int channels>
+void benchmarkBank() {
+	const int blockLength = 256;
+	BiquadBank<float, channels> bank;
+	std::vector<BiquadStatic<float>> reference(channels);
+	for (int c = 0; c < channels; ++c) {
+		reference[c].lowpass(0.01 + c*0.0005);
+		bank.set(c, reference[c]);
+	}
+	std::vector<std::vector<float>> data(channels, std::vector<float>(blockLength, 0.1f));
+	int repeats = std::max(20, 2000000/channels);
+
+	double bankNs = test::nsPer([&]() {
+		bank.process(data, data, blockLength);
+	}, repeats/blockLength, double(blockLength)*channels);
+	double staticNs = test::nsPer([&]() {
+		for (int c = 0; c < channels; ++c) {
+			float *channel = data[c].data();
+			for (int i = 0; i < blockLength; ++i) channel[i] = reference[c](channel[i]);
+		}
+	}, repeats/blockLength, double(blockLength)*channels);
+	std::printf("\tBiquadBank<float, %d>: bank %.3f, BiquadStatic %.3f\n", channels, bankNs, staticNs);
+}
+
+void benchmarkCascade(int sections) {
+	const int blockLength = 256;
+	BiquadCascade<float> cascade(sections);
+	std::vector<BiquadStatic<float>> reference(sections);
+	for (int k = 0; k < sections; ++k) {
+		reference[k].peakDb(0.01*(k + 1), 3);
+		cascade[k].peakDb(0.01*(k + 1), 3);
+	}
+	std::vector<float> data(blockLength, 0.1f);
+
+	double cascadeNs = test::nsPer([&]() {
+		cascade.process(data, data, blockLength);
+	}, 10000, blockLength);
+	double staticNs = test::nsPer([&]() {
+		for (auto &x : data) {
+			for (auto &biquad : reference) x = biquad(x);
+		}
+	}, 10000, blockLength);
+	std::printf("\tBiquadCascade<float> (%d sections): cascade %.3f, BiquadStatic %.3f\n", sections, cascadeNs, staticNs);
+}
+
+int main(int argc, char **argv) {
+	testBank<float, 1>("float");
+	testBank<float, 8>("float");
+	testBank<float, 13>("float");
+	testBank<double, 2>("double");
+	testBank<double, 13>("double");
+	testBank<float, 40>("float");
+	for (int sections : {1, 2, 3, 4, 5, 8, 11}) {
+		testCascade<float>("float", sections);
+		testCascade<double>("double", sections);
+	}
+
+	if (test::benchMode(argc, argv)) {
+		std::printf("Biquads: ns per channel-sample\n");
+		benchmarkBank<1>();
+		benchmarkBank<8>();
+		benchmarkBank<32>();
+		benchmarkBank<128>();
+		for (int sections : {2, 4, 8, 16}) benchmarkCascade(sections);
+	}
+	return test::finish("dsp/filters");
+}
@@ -0,0 +1,50 @@
+#ifndef IMAGIRO_UTIL_TEST_COMMON_H
+#define IMAGIRO_UTIL_TEST_COMMON_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+/** Minimal helpers for the header-only DSP tests.
+
+	Each test is its own executable, which returns non-zero if any check failed.  Run with `--bench` to also print timings (comparing the block/SIMD paths against the per-sample/scalar ones).
+*/
+namespace test {
+	static int failures = 0;
+
+	inline bool check(bool ok, const char *what) {
+		if (!ok) {
+			++failures;
+			std::printf("FAILED: %s\n", what);
+		}
+		return ok;
+	}
+
+	inline bool benchMode(int argc, char **argv) {
+		for (int i = 1; i < argc; ++i) {
+			if (!std::strcmp(argv[i], "--bench")) return true;
+		}
+		return false;
+	}
+
+	/// Runs `fn()` `repeats` times, returning the time in nanoseconds per `itemsPerRepeat`
+	template<class Fn>
+	double nsPer(Fn &&fn, int repeats, double itemsPerRepeat) {
+		fn(); // warm-up
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < repeats; ++r) fn();
+		std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+		return seconds.count()*1e9/repeats/itemsPerRepeat;
+	}
+
+	inline int finish(const char *name) {
+		if (failures) {
+			std::printf("%s: %d failure(s)\n", name, failures);
+			return 1;
+		}
+		std::printf("%s: passed\n", name);
+		return 0;
+	}
+}
+
+#endif // include guard